@@ -6,4 +6,22 @@
 
 #include "gtest/gtest.h"
 
-#include "mDictionary.h"
\ No newline at end of file
+#include "mDictionary.h"
+#include "CustAllocatorDict.h"
+#include "ClosedHashDict.h"
+#include "mFlatMap.h"
+#include "mRadixTree.h"
+#include "mMultiDictionary.h"
+#include "mSnapshotDictionary.h"
+#include "mHashSet.h"
+#include "mAggregate.h"
+#include "mPersistentDictionary.h"
+#include "mCounterMap.h"
+#include "mLinearDictionary.h"
+#include "mSlotMap.h"
+#include "mSparseSet.h"
+#include "mSmallArray.h"
+#include "mChunkedArray.h"
+#include "mSimd.h"
+#include "mParallel.h"
+#include "mSoAArray.h"
\ No newline at end of file
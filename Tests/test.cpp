@@ -46,4 +46,898 @@ namespace mContainers {
 		EXPECT_TRUE(defaultConstruct[2] == scalar);
 	}
 
+	class FlatMapFixtures : public ::testing::Test
+	{
+	protected:
+		mFlatMap<int, int> map;
+
+		virtual void SetUp() override
+		{
+			for (int i = 0; i < 100; i++)
+				map.insert(i * 2, i);
+
+			map.insert(10, -1);
+			map.commit();
+		}
+	};
+
+	TEST_F(FlatMapFixtures, FlatMapLookup)
+	{
+		EXPECT_TRUE(map.size() == 100);
+		EXPECT_TRUE(map[10] == -1);
+		EXPECT_TRUE(map[198] == 99);
+		EXPECT_TRUE(map.find(11) == nullptr);
+		EXPECT_TRUE(map.lower_bound(11) == 6);
+		EXPECT_TRUE(map.lower_bound(500) == map.size());
+	}
+
+	TEST_F(FlatMapFixtures, FlatMapFrozen)
+	{
+		map.insert(7, 7);
+		map.freeze();
+
+		EXPECT_TRUE(map.size() == 101);
+		EXPECT_TRUE(map[7] == 7);
+		EXPECT_TRUE(map[10] == -1);
+		EXPECT_TRUE(map.lower_bound(-5) == 0);
+		EXPECT_TRUE(map.lower_bound(9) == 6);
+		EXPECT_TRUE(map.lower_bound(500) == map.size());
+		EXPECT_TRUE(map.find(9) == nullptr);
+	}
+
+	class RadixTreeFixtures : public ::testing::Test
+	{
+	protected:
+		mRadixTree<int> tree;
+
+		virtual void SetUp() override
+		{
+			tree.insert("route/a", 1);
+			tree.insert("route/ab", 2);
+			tree.insert("route/b", 3);
+			tree.insert("other", 4);
+			tree.insert("route", 5);
+		}
+	};
+
+	TEST_F(RadixTreeFixtures, RadixTreeLookup)
+	{
+		EXPECT_TRUE(tree.size() == 5);
+		EXPECT_TRUE(*tree.find("route/ab") == 2);
+		EXPECT_TRUE(*tree.find("route") == 5);
+		EXPECT_TRUE(tree.find("route/") == nullptr);
+		EXPECT_TRUE(tree.lower_bound("route/aa")->value == 2);
+		EXPECT_TRUE(tree.lower_bound("zzz") == nullptr);
+
+		EXPECT_TRUE(tree.erase("route/a"));
+		EXPECT_TRUE(tree.find("route/a") == nullptr);
+		EXPECT_TRUE(*tree.find("route/ab") == 2);
+	}
+
+	TEST_F(RadixTreeFixtures, RadixTreePrefix)
+	{
+		int sum = 0;
+		tree.forEachPrefix("route/", [&](mRadixTree<int>::Entry& entry) { sum = sum * 10 + entry.value; });
+		EXPECT_TRUE(sum == 123);
+
+		mRadixTree<int> numbers;
+		for (int i = -300; i < 300; i++)
+			numbers[i] = i;
+
+		int previous = -301;
+		bool ordered = true;
+		numbers.forEach([&](mRadixTree<int>::Entry& entry) { ordered &= entry.value == previous + 1; previous = entry.value; });
+		EXPECT_TRUE(ordered && previous == 299);
+		EXPECT_TRUE(numbers.lower_bound(-5)->value == -5);
+	}
+
+	class MultiDictionaryFixtures : public ::testing::Test
+	{
+	protected:
+		mMultiDictionary<int, int> dict;
+
+		virtual void SetUp() override
+		{
+			for (int i = 0; i < 30; i++)
+				dict.insert(i % 3, i);
+		}
+	};
+
+	TEST_F(MultiDictionaryFixtures, MultiDictionaryGroups)
+	{
+		EXPECT_TRUE(dict.size() == 30);
+		EXPECT_TRUE(dict.keyCount() == 3);
+		EXPECT_TRUE(dict.count(1) == 10);
+
+		mSpan<int> values = dict.equal_range(2);
+		EXPECT_TRUE(values.size() == 10);
+		EXPECT_TRUE(values[0] == 2 && values[9] == 29);
+		EXPECT_TRUE(dict.equal_range(5).empty());
+	}
+
+	TEST_F(MultiDictionaryFixtures, MultiDictionaryCompact)
+	{
+		dict.erase(0);
+		dict.compact();
+
+		EXPECT_TRUE(dict.wasted() == 0);
+		EXPECT_TRUE(dict.size() == 20);
+		EXPECT_TRUE(!dict.contains(0));
+
+		int sum = 0;
+		for (int value : dict.equal_range(1))
+			sum += value;
+		EXPECT_TRUE(sum == 145);
+	}
+
+	TEST(SnapshotDictionaryTests, SnapshotPublish)
+	{
+		using Map = mFlatMap<int, int>;
+		mSnapshotDictionary<Map> dict;
+		mSnapshotDictionary<Map>::Reader reader(dict);
+
+		dict.update([](Map& map) { map.insert(1, 10); map.commit(); });
+		{
+			auto snapshot = reader.read();
+			dict.update([](Map& map) { map.insert(1, 20); map.commit(); });
+
+			// The pinned version is unchanged and can't be reclaimed yet
+			EXPECT_TRUE((*snapshot)[1] == 10);
+			EXPECT_TRUE(dict.reclaim() == 1);
+		}
+
+		EXPECT_TRUE(dict.reclaim() == 0);
+		EXPECT_TRUE((*reader.read())[1] == 20);
+	}
+
+	template<typename Dict>
+	void CheckSnapshotCopies()
+	{
+		mSnapshotDictionary<Dict> dict;
+		typename mSnapshotDictionary<Dict>::Reader reader(dict);
+
+		// Every version is a copy of the last, and the copies rehash as they grow
+		bool pinned = true;
+		for (int version = 0; version < 20; version++)
+		{
+			auto snapshot = reader.read();
+			dict.update([&](Dict& map) { for (int i = 0; i < 50; i++) map[version * 50 + i] = version; });
+			pinned &= !snapshot->contains(version * 50);
+		}
+		EXPECT_TRUE(pinned && dict.reclaim() == 0);
+
+		auto snapshot = reader.read();
+		bool found = true;
+		for (int i = 0; i < 1000; i++)
+			found &= (*snapshot)[i] == i / 50;
+		EXPECT_TRUE(found);
+
+		Dict copy = *snapshot;
+		copy[0] = -1;
+		EXPECT_TRUE(copy[0] == -1 && (*snapshot)[0] == 0 && copy[999] == 19);
+	}
+
+	TEST(SnapshotDictionaryTests, UpdateCopiesDictionaries)
+	{
+		CheckSnapshotCopies<mDictionary<int, int>>();
+		CheckSnapshotCopies<TestDictionary<int, int>>();
+		CheckSnapshotCopies<OldDictionary<int, int>>();
+	}
+
+	TEST(SnapshotDictionaryTests, ReaderWaitsForFreeSlot)
+	{
+		using Map = mFlatMap<int, int>;
+		mSnapshotDictionary<Map, 2> dict;
+		std::atomic<bool> registered = false;
+
+		std::thread thread;
+		{
+			mSnapshotDictionary<Map, 2>::Reader first(dict), second(dict);
+			thread = std::thread([&]()
+			{
+				mSnapshotDictionary<Map, 2>::Reader third(dict);
+				registered = true;
+				EXPECT_TRUE(third.read()->size() == 0);
+			});
+
+			// Both slots are held, so the third reader can't have been registered yet
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			EXPECT_TRUE(!registered);
+		}
+
+		thread.join();
+		EXPECT_TRUE(registered);
+	}
+
+	TEST(DictionaryTests, DictionaryParallelReHash)
+	{
+		// ParallelReHash needs more than one thread, and the table grows by doubling, so several rehashes
+		// have to happen past PARALLEL_REHASH_SIZE
+		mThreadPool pool(4);
+		mThreadPool::Scope scope(pool);
+		EXPECT_TRUE(mThreadPool::Get().size() == 4);
+
+		const int count = PARALLEL_REHASH_SIZE * 4;
+		mDictionary<int, int> dict;
+		for (int i = 0; i < count; i++)
+			dict[i] = i * 2;
+
+		bool found = true;
+		for (int i = 0; i < count; i++)
+			found &= dict[i] == i * 2;
+		EXPECT_TRUE(found);
+	}
+
+	TEST(DictionaryTests, TestDictionaryParallelReHash)
+	{
+		// ParallelReHash needs more than one thread, and the table grows by doubling, so several rehashes
+		// have to happen past PARALLEL_REHASH_SIZE
+		mThreadPool pool(4);
+		mThreadPool::Scope scope(pool);
+		EXPECT_TRUE(mThreadPool::Get().size() == 4);
+
+		const int count = PARALLEL_REHASH_SIZE * 4;
+		TestDictionary<int, int> dict;
+		for (int i = 0; i < count; i++)
+			dict[i] = i * 2;
+
+		bool found = true;
+		for (int i = 0; i < count; i++)
+			found &= dict[i] == i * 2;
+		EXPECT_TRUE(found && !dict.contains(count));
+	}
+
+	TEST(DictionaryTests, OldDictionaryOverflowBuckets)
+	{
+		// A higher load factor so a single bucket can fill past MAX_BUCKET_SIZE before the table grows
+		const size_t maxLoad = 4;
+		OldDictionary<int, int, maxLoad> dict;
+		const size_t buckets = dict.bucketCount();
+
+		mDynArray<int> colliding;
+		for (int key = 0; colliding.size() < MAX_BUCKET_SIZE * 2 + 1; key++)
+			if (dict.hash_key(key) % buckets == dict.hash_key(0) % buckets)
+				colliding.emplace_back(key);
+
+		// Below the load limit the bucket spills into overflow blocks and the table keeps its size
+		bool sameBuckets = true;
+		for (size_t i = 0; i < colliding.size(); i++)
+		{
+			dict.insert(colliding[i], colliding[i] * 3);
+			sameBuckets &= dict.size() / buckets < maxLoad && dict.bucketCount() == buckets;
+		}
+		EXPECT_TRUE(sameBuckets);
+
+		bool found = true;
+		for (size_t i = 0; i < colliding.size(); i++)
+			found &= dict.find(colliding[i]) && *dict.find(colliding[i]) == colliding[i] * 3;
+		EXPECT_TRUE(found);
+
+		// Growing frees the overflow slabs and rebuilds the buckets from the stored keys
+		bool inserted = true;
+		for (int key = 0; key < 1000; key++)
+		{
+			bool existing = dict.contains(key);
+			auto [val, added] = dict.try_emplace(key, key * 3);
+			inserted &= added != existing && *val == key * 3;
+		}
+		EXPECT_TRUE(inserted && dict.bucketCount() > buckets && dict.size() == 1000);
+
+		found = true;
+		for (int key = 0; key < 1000; key++)
+			found &= dict.find(key) && *dict.find(key) == key * 3;
+		EXPECT_TRUE(found && !dict.contains(1000));
+	}
+
+	template<typename Set>
+	void CheckSetOperations()
+	{
+		Set lhs, rhs;
+		for (int i = 0; i < 100; i++)
+			lhs.insert(i);
+		for (int i = 50; i < 150; i++)
+			rhs.insert(i);
+
+		EXPECT_TRUE(!lhs.insert(10));
+		EXPECT_TRUE(lhs.erase(99) && !lhs.contains(99));
+		lhs.insert(99);
+
+		Set both = SetIntersection(lhs, rhs);
+		Set either = SetUnion(lhs, rhs);
+		Set left = SetDifference(lhs, rhs);
+		EXPECT_TRUE(both.size() == 50 && either.size() == 150 && left.size() == 50);
+		EXPECT_TRUE(both.contains(75) && !both.contains(25));
+		EXPECT_TRUE(either.contains(0) && either.contains(149));
+		EXPECT_TRUE(left.contains(49) && !left.contains(50));
+	}
+
+	TEST(HashSetTests, SetOperations)
+	{
+		CheckSetOperations<mHashSet<int>>();
+		CheckSetOperations<mDenseHashSet<int>>();
+		CheckSetOperations<mFlatHashSet<int>>();
+	}
+
+	template<typename Set>
+	void CheckParallelSetOperations()
+	{
+		const int count = PARALLEL_SET_SIZE + 5000;
+		Set lhs, rhs;
+		for (int i = 0; i < count; i++)
+		{
+			lhs.insert(i);
+			rhs.insert(i + count / 2);
+		}
+
+		Set both = SetIntersection(lhs, rhs);
+		Set either = SetUnion(lhs, rhs);
+		Set left = SetDifference(lhs, rhs);
+		EXPECT_TRUE(both.size() == (uint64_t)(count - count / 2) && either.size() == (uint64_t)(count + count / 2) && left.size() == (uint64_t)(count / 2));
+
+		bool found = true;
+		for (int i = 0; i < count + count / 2; i++)
+			found &= either.contains(i) && both.contains(i) == (i >= count / 2 && i < count) && left.contains(i) == (i < count / 2);
+		EXPECT_TRUE(found);
+
+		// Keys already present, or repeated in the batch, are only inserted once
+		mDynArray<Utils::HashedKey<int>> batch;
+		for (int i = 0; i <= count * 2; i++)
+			batch.emplace_back(i, lhs.hash_key(i));
+		batch.emplace_back(count * 2, lhs.hash_key(count * 2));
+		lhs.insert_batch_hashed(batch);
+
+		bool erased = true;
+		for (int i = 0; i <= count * 2; i += 2)
+			erased &= lhs.erase(i);
+		EXPECT_TRUE(erased && lhs.size() == (uint64_t)count);
+
+		found = true;
+		for (int i = 0; i <= count * 2; i++)
+			found &= lhs.contains(i) == (i % 2 == 1);
+		EXPECT_TRUE(found);
+	}
+
+	TEST(HashSetTests, ParallelSetOperations)
+	{
+		CheckParallelSetOperations<mHashSet<int>>();
+		CheckParallelSetOperations<mDenseHashSet<int>>();
+		CheckParallelSetOperations<mFlatHashSet<int>>();
+	}
+
+	TEST(AggregateTests, ReduceByKey)
+	{
+		mDynArray<int> keys, values;
+		for (int i = 0; i < 1000; i++)
+		{
+			keys.emplace_back(i % 10);
+			values.emplace_back(i);
+		}
+
+		auto sums = ReduceByKey(keys, values, [](int& sum, const int& value) { sum += value; });
+
+		EXPECT_TRUE(sums.size() == 10);
+		EXPECT_TRUE(sums[0] == 49500 && sums[9] == 50400);
+	}
+
+	TEST(AggregateTests, ReduceByKeyMatchesSerial)
+	{
+		// Large enough for the local tables and the partition merge, with keys spread over every partition
+		const int count = PARALLEL_AGGREGATE_SIZE + 5000;
+		const int distinct = 7919;
+		mDynArray<int> keys, values;
+		mDynArray<long long> expected(distinct, 0);
+		for (int i = 0; i < count; i++)
+		{
+			int key = (int)(((uint64_t)i * 104729) % distinct);
+			keys.emplace_back(key);
+			values.emplace_back(i);
+			expected[key] += i;
+		}
+
+		auto sums = ReduceByKey(keys, values, [](int& sum, const int& value) { sum += value; });
+
+		bool matches = sums.size() == (uint64_t)distinct;
+		for (int key = 0; key < distinct; key++)
+			matches &= sums.contains(key) && sums[key] == expected[key];
+		EXPECT_TRUE(matches);
+	}
+
+	TEST(PersistentDictionaryTests, RecoverFromSnapshotAndLog)
+	{
+		std::string path = (std::filesystem::temp_directory_path() / "mContainersPersistTest").string();
+		std::filesystem::remove(path + ".snap");
+		std::filesystem::remove(path + ".log");
+
+		{
+			mPersistentDictionary<int, int> dict(path, 16);
+			for (int i = 0; i < 100; i++)
+				dict.insert(i, i * 2);
+			EXPECT_TRUE(dict.checkpoint());
+
+			// Only in the log
+			dict.insert(1, -1);
+			dict.insert(200, 400);
+			EXPECT_TRUE(dict.erase(2) && dict.erase(200) && !dict.erase(300));
+			dict.insert(200, 401);
+		}
+
+		{
+			mPersistentDictionary<int, int> dict(path);
+			EXPECT_TRUE(dict.dictionary()[1] == -1 && dict.dictionary()[50] == 100 && dict.dictionary()[200] == 401);
+			EXPECT_TRUE(!dict.dictionary().contains(2) && dict.dictionary().contains(3));
+
+			// The snapshot is written from the table, so erased keys must be gone from its iteration too
+			EXPECT_TRUE(dict.erase(3) && dict.checkpoint());
+		}
+
+		{
+			mPersistentDictionary<int, int> dict(path);
+			EXPECT_TRUE(!dict.dictionary().contains(2) && !dict.dictionary().contains(3) && dict.dictionary()[4] == 8);
+		}
+
+		std::filesystem::remove(path + ".snap");
+		std::filesystem::remove(path + ".log");
+	}
+
+	TEST(CounterMapTests, ConcurrentIncrements)
+	{
+		mCounterMap<int> counters;
+		std::thread threads[4];
+		for (std::thread& thread : threads)
+			thread = std::thread([&]() { for (int i = 0; i < 10000; i++) counters.add(i % 100); });
+		for (std::thread& thread : threads)
+			thread.join();
+
+		auto samples = counters.snapshot();
+		bool exact = samples.size() == 100;
+		for (auto& sample : samples)
+			exact &= sample.value == 400;
+		EXPECT_TRUE(exact);
+		EXPECT_TRUE(counters.get(5) == 400 && counters.get(500) == 0 && !counters.contains(500));
+	}
+
+	TEST(LinearDictionaryTests, GrowsOneBucketAtATime)
+	{
+		mLinearDictionary<int, int> dict;
+		bool oneSplit = true;
+		for (int i = 0; i < 5000; i++)
+		{
+			uint64_t buckets = dict.bucketCount();
+			dict[i] = i * 3;
+			oneSplit &= dict.bucketCount() - buckets <= 1;
+		}
+		EXPECT_TRUE(oneSplit && dict.size() == 5000);
+
+		bool found = true;
+		for (int i = 0; i < 5000; i++)
+			found &= dict.find(i) && *dict.find(i) == i * 3;
+		EXPECT_TRUE(found);
+
+		EXPECT_TRUE(dict.erase(42) && !dict.contains(42) && dict.size() == 4999);
+	}
+
+	TEST(SlotMapTests, HandlesSurviveErase)
+	{
+		mSlotMap<int> map;
+		mSlotHandle a = map.insert(1);
+		mSlotHandle b = map.insert(2);
+		mSlotHandle c = map.insert(3);
+
+		EXPECT_TRUE(map.erase(a) && !map.erase(a));
+		EXPECT_TRUE(map[b] == 2 && map[c] == 3 && map.size() == 2);
+
+		// The freed slot is reused, the old handle stays stale
+		mSlotHandle d = map.insert(4);
+		EXPECT_TRUE(d.index == a.index && !map.get(a) && map[d] == 4);
+	}
+
+	TEST(SparseSetTests, JoinWalksSmallestSet)
+	{
+		mSparseSet<float> positions, velocities;
+		for (uint32_t entity = 0; entity < 10000; entity++)
+			positions.insert(entity, 0.0f);
+		for (uint32_t entity = 0; entity < 10000; entity += 4)
+			velocities.insert(entity, 2.0f);
+
+		EXPECT_TRUE(positions.remove(8) && !positions.contains(8) && positions.size() == 9999);
+
+		int joined = 0;
+		SparseJoin([&](uint32_t, float& position, float& velocity) { position += velocity; joined++; }, positions, velocities);
+		EXPECT_TRUE(joined == 2499);
+		EXPECT_TRUE(positions[4] == 2.0f && positions[5] == 0.0f);
+	}
+
+	TEST(DictionaryTests, DictionaryHashedLookups)
+	{
+		mDictionary<int, int> primary;
+		mLinearDictionary<int, int> cache;
+		for (int i = 0; i < 1000; i++)
+		{
+			uint64_t hash = primary.hash_key(i);
+			primary.insert_hashed(i, hash, i);
+			if (i % 2 == 0) cache.insert_hashed(i, hash, -i);
+		}
+
+		// One hash serves both tables
+		uint64_t hash = primary.hash_key(500);
+		EXPECT_TRUE(*cache.find_hashed(500, hash) == -500 && *primary.find_hashed(500, hash) == 500);
+
+		hash = primary.hash_key(501);
+		EXPECT_TRUE(!cache.find_hashed(501, hash) && *primary.find_hashed(501, hash) == 501);
+	}
+
+	TEST(DictionaryTests, DictionaryTryEmplace)
+	{
+		mDictionary<int, int> dict;
+		auto [first, inserted] = dict.try_emplace(7, 70);
+		EXPECT_TRUE(inserted && *first == 70);
+
+		auto [second, insertedAgain] = dict.try_emplace(7, 700);
+		EXPECT_TRUE(!insertedAgain && second == first && *second == 70);
+
+		// Lookups of missing keys do not insert
+		EXPECT_TRUE(!dict.find(8) && !dict.contains(8) && dict.contains(7));
+		EXPECT_TRUE(dict.size() == 1);
+	}
+
+	TEST(DictionaryTests, DictionaryErase)
+	{
+		mDictionary<int, int> dict;
+		for (int i = 0; i < 1000; i++)
+			dict[i] = i;
+
+		// Erase in a scattered order, moving different links into each hole
+		bool erased = true;
+		for (int i = 0; i < 1000; i++)
+			if ((i * 7) % 3 == 0) erased &= dict.erase((i * 337) % 1000);
+		EXPECT_TRUE(erased && !dict.erase(-1));
+
+		for (int i = 1000; i < 2000; i++)
+			dict[i] = i;
+
+		uint64_t visited = 0;
+		bool consistent = true;
+		for (auto* kv : dict)
+		{
+			consistent &= dict.contains(kv->key) && kv->value == kv->key;
+			visited++;
+		}
+
+		int remaining = 0;
+		for (int i = 0; i < 2000; i++)
+			remaining += dict.contains(i) ? 1 : 0;
+		EXPECT_TRUE(consistent && visited == dict.size() && (uint64_t)remaining == dict.size());
+	}
+
+	TEST(DynArrayTests, GrowthRelocatesElements)
+	{
+		// Large enough to be mmap backed on Linux
+		mDynArray<float> floats;
+		for (int i = 0; i < 1000000; i++)
+			floats.emplace_back((float)i);
+		EXPECT_TRUE(floats.size() == 1000000 && floats[999999] == 999999.0f);
+
+		floats.resize(10);
+		EXPECT_TRUE(floats.size() == 10 && floats[9] == 9.0f);
+
+		mDynArray<std::string> strings(0);
+		for (int i = 0; i < 100; i++)
+			strings.push_back(std::to_string(i));
+		strings.push_back(strings[0]);
+		EXPECT_TRUE(strings.size() == 101 && strings[99] == "99" && strings[100] == "0");
+	}
+
+	TEST(SmallArrayTests, SpillsPastInlineCapacity)
+	{
+		mSmallArray<std::string, 4> names;
+		for (int i = 0; i < 4; i++)
+			names.emplace_back(std::to_string(i));
+		EXPECT_TRUE(names.isInline() && names.size() == 4);
+
+		names.push_back(names[0]);
+		EXPECT_TRUE(!names.isInline() && names[4] == "0");
+
+		names.erase(names.begin() + 1, names.begin() + 3);
+		EXPECT_TRUE(names.size() == 3 && names[0] == "0" && names[1] == "3" && names[2] == "0");
+
+		mSmallArray<std::string, 4> moved(std::move(names));
+		EXPECT_TRUE(names.empty() && names.isInline() && moved.size() == 3 && *moved.find("3") == "3");
+	}
+
+	// Stateful allocator counting the bytes each container instance holds
+	struct CountingAllocator
+	{
+		int64_t* bytes;
+
+		CountingAllocator(int64_t* _bytes = nullptr) : bytes(_bytes) {}
+
+		template<typename T>
+		T* Alloc(uint64_t size)
+		{
+			*bytes += size * sizeof(T);
+			return Memory::Alloc<T>(size);
+		}
+		template<typename T>
+		void Free(T* data, uint64_t size)
+		{
+			*bytes -= size * sizeof(T);
+			Memory::Free<T>(data, size);
+		}
+	};
+
+	TEST(AllocatorTests, ContainersUseInstanceAllocator)
+	{
+		int64_t arrayBytes = 0, dictBytes = 0;
+		{
+			mDynArray<std::string, CountingAllocator> names{ CountingAllocator(&arrayBytes) };
+			for (int i = 0; i < 100; i++)
+				names.emplace_back(std::to_string(i));
+
+			mDictionary<int, int, 1, CountingAllocator> dict{ CountingAllocator(&dictBytes) };
+			for (int i = 0; i < 1000; i++)
+				dict[i] = i;
+
+			EXPECT_TRUE(arrayBytes >= int64_t(100 * sizeof(std::string)) && dictBytes > 0);
+			EXPECT_TRUE(*dict.find(999) == 999);
+		}
+		EXPECT_TRUE(arrayBytes == 0 && dictBytes == 0);
+
+		// The default allocator adds no storage
+		EXPECT_TRUE(sizeof(mList<int>) == sizeof(void*) + sizeof(uint64_t));
+	}
+
+	// Fills a container built on a CountingAllocator, which must take memory from it and give all of it back
+	template<typename Container, typename Fill>
+	bool CheckAllocatorBalance(Fill&& fill)
+	{
+		int64_t bytes = 0;
+		bool used = false;
+		{
+			Container container{ CountingAllocator(&bytes) };
+			fill(container, used, bytes);
+		}
+		return used && bytes == 0;
+	}
+
+	TEST(AllocatorTests, EveryContainerUsesInstanceAllocator)
+	{
+		using Alloc = CountingAllocator;
+		using LinearDict = mLinearDictionary<int, int, 1, Alloc>;
+		using MultiDict = mMultiDictionary<int, int, 2, 1, Alloc>;
+		using FlatMap = mFlatMap<int, int, Alloc>;
+		using RadixTree = mRadixTree<int, Alloc>;
+		using SlotMap = mSlotMap<int, Alloc>;
+		using SparseSet = mSparseSet<int, uint32_t, Alloc>;
+		using CounterMap = mCounterMap<int, int64_t, Alloc>;
+		using HashSet = mHashSet<int, 1, Alloc>;
+		using DenseHashSet = mDenseHashSet<int, 1, Alloc>;
+		using FlatHashSet = mFlatHashSet<int, Alloc>;
+		using SoAArray = mBasicSoAArray<Alloc, float, std::string>;
+
+		EXPECT_TRUE(CheckAllocatorBalance<LinearDict>([](auto& dict, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 5000; i++)
+				dict[i] = i;
+			used = dict.erase(7) && bytes > int64_t(4999 * 2 * sizeof(int));
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<MultiDict>([](auto& dict, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 1000; i++)
+				dict.insert(i % 10, i);
+			dict.compact();
+			used = dict.count(3) == 100 && bytes > 0;
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<FlatMap>([](auto& map, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 1000; i++)
+				map.insert(i, i);
+			map.freeze();
+			used = *map.find(500) == 500 && bytes > 0;
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<RadixTree>([](auto& tree, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 1000; i++)
+				tree[std::to_string(i)] = i;
+			used = tree.erase("500") && *tree.find("499") == 499 && bytes > 0;
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<SlotMap>([](auto& map, bool& used, int64_t& bytes)
+		{
+			mSlotHandle handle = map.insert(1);
+			used = map.erase(handle) && bytes > 0;
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<SparseSet>([](auto& set, bool& used, int64_t& bytes)
+		{
+			set.insert(10000, 1);
+			used = bytes >= int64_t(4096 * sizeof(uint32_t));
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<CounterMap>([](auto& counters, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 1000; i++)
+				counters.add(i);
+			used = counters.get(999) == 1 && bytes > 0;
+		}));
+		EXPECT_TRUE(CheckAllocatorBalance<SoAArray>([](auto& particles, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 100; i++)
+				particles.push_back((float)i, std::to_string(i));
+
+			auto copy = particles;
+			used = copy.template get<1>(99) == "99" && bytes >= int64_t(2 * 100 * (sizeof(float) + sizeof(std::string)));
+		}));
+
+		// Set operation results take the allocator of lhs
+		auto checkSet = [](auto& set, bool& used, int64_t& bytes)
+		{
+			for (int i = 0; i < 1000; i++)
+				set.insert(i);
+
+			int64_t before = bytes;
+			auto copy = SetUnion(set, set);
+			used = copy.size() == 1000 && set.erase(7) && bytes > before;
+		};
+		EXPECT_TRUE(CheckAllocatorBalance<HashSet>(checkSet));
+		EXPECT_TRUE(CheckAllocatorBalance<DenseHashSet>(checkSet));
+		EXPECT_TRUE(CheckAllocatorBalance<FlatHashSet>(checkSet));
+	}
+
+	TEST(DynArrayTests, LazyAllocationAndGrowthPolicy)
+	{
+		mDynArray<int> empty;
+		EXPECT_TRUE(empty.capacity() == 0 && empty.begin() == empty.end());
+
+		mDynArray<int, Memory, Growth::OneAndHalf> values;
+		uint64_t capacity = 0;
+		for (int i = 0; i < 1000; i++)
+		{
+			values.push_back(i);
+			if (values.capacity() == capacity) continue;
+
+			// Each step grows by half
+			EXPECT_TRUE(capacity < 4 || values.capacity() == capacity + capacity / 2);
+			capacity = values.capacity();
+		}
+		EXPECT_TRUE(values.size() == 1000 && values[999] == 999);
+	}
+
+	TEST(ChunkedArrayTests, AddressesStayStable)
+	{
+		mChunkedArray<std::string, 4> names;
+		names.emplace_back("first");
+		const std::string* first = &names[0];
+		for (int i = 0; i < 100; i++)
+			names.push_back(names[0]);
+		EXPECT_TRUE(&names[0] == first && names.size() == 101 && names.chunkCount() == 26);
+
+		uint64_t visited = 0;
+		for (const std::string& name : names)
+			visited += name == "first";
+		EXPECT_TRUE(visited == 101);
+
+		uint64_t chunks = 0;
+		names.forEachChunk([&](std::string*, uint64_t count) { chunks++; EXPECT_TRUE(count == 4 || (chunks == 26 && count == 1)); });
+		EXPECT_TRUE(chunks == 26);
+	}
+
+	TEST(DynArrayTests, BulkAppendInsertAssign)
+	{
+		int source[] = { 1, 2, 3, 4 };
+		mDynArray<int> values;
+		values.append(source, source + 4);
+		values.append_n(2, 9);
+		EXPECT_TRUE(values.size() == 6 && values[3] == 4 && values[5] == 9);
+
+		// Ranges from the array itself are copied before it grows
+		values.insert(values.begin() + 1, values.begin(), values.end());
+		int expected[] = { 1, 1, 2, 3, 4, 9, 9, 2, 3, 4, 9, 9 };
+		EXPECT_TRUE(values.size() == 12);
+		for (uint64_t i = 0; i < values.size(); i++)
+			EXPECT_TRUE(values[i] == expected[i]);
+
+		mList<std::string> names(3, "x");
+		mDynArray<std::string> copies;
+		copies.assign(names.begin(), names.end());
+		copies.assign(2, copies[0]);
+		EXPECT_TRUE(copies.size() == 2 && copies[1] == "x");
+	}
+
+	TEST(DynArrayTests, EraseKeepsOrderAndSwapRemoveDoesNot)
+	{
+		mDynArray<std::string> names;
+		for (const char* name : { "a", "b", "c", "d", "e", "f" })
+			names.push_back(name);
+
+		names.erase(names.begin() + 1, names.begin() + 3);
+		names.erase(names.begin());
+		EXPECT_TRUE(names.size() == 3 && names[0] == "d" && names[2] == "f");
+
+		names.swap_remove(0);
+		EXPECT_TRUE(names.size() == 2 && names[0] == "f" && names[1] == "e");
+
+		mDynArray<int> values;
+		for (int i = 0; i < 10; i++)
+			values.push_back(i);
+
+		EXPECT_TRUE(values.erase_if([](int v) { return v % 3 == 0; }) == 4);
+		int expected[] = { 1, 2, 4, 5, 7, 8 };
+		EXPECT_TRUE(values.size() == 6);
+		for (uint64_t i = 0; i < values.size(); i++)
+			EXPECT_TRUE(values[i] == expected[i]);
+	}
+
+	TEST(DynArrayTests, VectorisedSearch)
+	{
+		// Sizes that leave a scalar tail after the vector blocks
+		mDynArray<int> values;
+		for (int i = 0; i < 1003; i++)
+			values.push_back(i % 100 - 50);
+
+		EXPECT_TRUE(values.find(49) == values.begin() + 99);
+		EXPECT_TRUE(values.find(1000) == values.end());
+		EXPECT_TRUE(values.count(-50) == 11 && values.contains(2) && !values.contains(-51));
+		EXPECT_TRUE(values.find_if_equal_any({ 1000, 7, -3 }) == values.begin() + 47);
+		EXPECT_TRUE(values.min() == -50 && values.max() == 49);
+
+		mDynArray<float> floats(37, 1.0f);
+		floats[30] = -0.0f;
+		EXPECT_TRUE(floats.find(0.0f) == floats.begin() + 30);
+		EXPECT_TRUE(floats.min() == 0.0f && floats.max() == 1.0f);
+
+		mDynArray<uint64_t> large(70, 1);
+		large[69] = ~0ull;
+		EXPECT_TRUE(large.max() == ~0ull && large.count(1) == 69);
+	}
+
+	TEST(ParallelTests, AlgorithmsMatchSerial)
+	{
+		// Large enough for several chunks when the machine has more than one thread
+		const uint64_t count = PARALLEL_GRAIN * 5 + 3;
+		mDynArray<int> values;
+		for (uint64_t i = 0; i < count; i++)
+			values.push_back((int)((i * 7919) % 1000));
+
+		mDynArray<int> doubled(count);
+		Parallel::Transform(values, doubled, [](int v) { return v * 2; });
+		EXPECT_TRUE(doubled[count - 1] == values[count - 1] * 2);
+
+		uint64_t serialSum = 0;
+		for (uint64_t i = 0; i < count; i++)
+			serialSum += values[i];
+		EXPECT_TRUE(Parallel::Reduce(values, (uint64_t)0, [](uint64_t a, uint64_t b) { return a + b; }) == serialSum);
+		EXPECT_TRUE(Parallel::CountIf(values, [](int v) { return v == 0; }) == (count + 999) / 1000);
+		EXPECT_TRUE(Parallel::MinElement(values) == 0);
+
+		Parallel::Sort(values);
+		bool sorted = true;
+		for (uint64_t i = 1; i < count; i++)
+			sorted &= values[i - 1] <= values[i];
+		EXPECT_TRUE(sorted);
+
+		// Stable sort by the lowest digit keeps the ascending order within each digit
+		Parallel::StableSort(values, [](int a, int b) { return a % 10 < b % 10; });
+		bool stable = true;
+		for (uint64_t i = 1; i < count; i++)
+			stable &= values[i - 1] % 10 < values[i] % 10 || values[i - 1] <= values[i];
+		EXPECT_TRUE(stable);
+	}
+
+	TEST(SoAArrayTests, ColumnsAreContiguousAndAligned)
+	{
+		mSoAArray<float, std::string, char> particles;
+		for (int i = 0; i < 100; i++)
+			particles.push_back((float)i, std::to_string(i), (char)('a' + i % 26));
+
+		// Rows are tuples of references into the columns
+		for (auto [mass, name, tag] : particles)
+			mass *= 2.0f;
+		particles[3] = std::make_tuple(-1.0f, std::string("three"), 'z');
+
+		mSpan<float> masses = particles.column<0>();
+		EXPECT_TRUE(masses.size() == 100 && masses[10] == 20.0f && masses[3] == -1.0f);
+		EXPECT_TRUE(particles.get<1>(3) == "three" && particles.get<1>(99) == "99");
+		EXPECT_TRUE((uintptr_t)particles.column<1>().data() % 64 == 0 && (uintptr_t)particles.column<2>().data() % 64 == 0);
+
+		particles.swap_remove(0);
+		EXPECT_TRUE(particles.size() == 99 && particles.get<1>(0) == "99" && particles.get<0>(0) == 198.0f);
+	}
+
 }
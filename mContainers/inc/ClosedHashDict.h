@@ -3,20 +3,17 @@
 #include "mCore.h"
 #include "mList.h"
 #include "mDynArray.h"
+#include "mChunkedArray.h"
+#include "mThreadPool.h"
 
 #include "mUtils.h"
 
-// Hash Table Default Parameters
-#define DEFAULT_BUCKETS 7
-#define LOAD_SCALE      2
-#define MAX_BUCKET_SIZE 4
-
 namespace mContainers {
 
     static bool sLimitBucketSize = false;
 
     // Key and Value type must be default constructable for linked list head
-    template<typename Key, typename Val, uint64_t MaxLoad = 1>
+    template<typename Key, typename Val, uint64_t MaxLoad = 1, typename Allocator = Memory>
     class TestDictionary
     {
     private:
@@ -58,41 +55,101 @@ namespace mContainers {
         };
 
     private:
-        using Bucket = mList<KeyIndexPair>;
+        using Bucket = mList<KeyIndexPair, Allocator>;
+
+        // Only the default allocator is assumed to be safe to call from the rehash tasks
+        static constexpr bool ParallelAllocator = std::is_same_v<Allocator, Memory>;
+
+        // Bucket length that forces a rehash when sLimitBucketSize is set
+        static constexpr uint64_t MaxBucketSize = 4;
 
     private:
-        mDynArray<Bucket> mBuckets;
-        mDynArray<KeyValPair> mData;
+        mDynArray<Bucket, Allocator> mBuckets;
+        mChunkedArray<KeyValPair, 256, Allocator> mData; // Stable, buckets refer to the keys in place
         uint64_t mSize;
         uint64_t mBucketCount;
         uint64_t mMaxLoad;
 
     public:
-        TestDictionary()
-            : mBuckets(DEFAULT_BUCKETS), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+        TestDictionary(const Allocator& allocator = Allocator())
+            : mBuckets(DEFAULT_BUCKETS, Bucket(allocator), allocator), mData(allocator), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
 
-    public: // Access Operators
-        Val& operator[](const Key& key)
+        // The buckets refer to keys in mData, so they are rebuilt over the copied entries
+        TestDictionary(const TestDictionary& other)
+            : mBuckets(other.mBucketCount, Bucket(other.allocator()), other.allocator()), mData(other.mData),
+            mSize(other.mSize), mBucketCount(other.mBucketCount), mMaxLoad(other.mMaxLoad)
         {
-            Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
+            for (uint64_t i = 0; i < mData.size(); i++)
+                mBuckets[Hash(mData[i].key)].emplace_front(mData[i].key, i);
+        }
 
-            if (bucket.size() == 0) return Add(key);
-            auto it = bucket.find(key);
-            if (it != bucket.end()) return mData[(*it).index];
+        TestDictionary(TestDictionary&& other)
+            : TestDictionary(other.allocator())
+        {
+            swap(other);
+        }
+
+        TestDictionary& operator=(const TestDictionary& other)
+        {
+            if (this == &other) return *this;
 
-            return Add(key);
+            TestDictionary copy(other);
+            swap(copy);
+            return *this;
+        }
+        TestDictionary& operator=(TestDictionary&& other)
+        {
+            swap(other);
+            return *this;
+        }
+
+        void swap(TestDictionary& other)
+        {
+            mBuckets.swap(other.mBuckets);
+            mData.swap(other.mData);
+            std::swap(mSize, other.mSize);
+            std::swap(mBucketCount, other.mBucketCount);
+            std::swap(mMaxLoad, other.mMaxLoad);
+        }
+
+        const Allocator& allocator() const { return mBuckets.allocator(); }
+
+    public: // Access Operators
+        Val& operator[](const Key& key)
+        {
+            return *try_emplace(key).first;
         }
 
         const Val& operator[](const Key& key) const
         {
-            const Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
+            const Val* val = find(key);
+            mAssert(val, "Key not in hash table!");
+
+            return *val;
+        }
 
-            assert(bucket.size() == 0);
+        // Lookups that never insert
+        Val* find(const Key& key) { return find_hashed(key, hash_key(key)); }
+        const Val* find(const Key& key) const { return find_hashed(key, hash_key(key)); }
+        bool contains(const Key& key) const { return find(key) != nullptr; }
 
-            const auto it = bucket.find(key);
-            assert(it != bucket.end());
+        // Full hash of a key. Callers probing several tables for the same key can hash it once and pass
+        // the result to the *_hashed methods of each.
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
 
-            return (*it).value;
+        Val* find_hashed(const Key& key, uint64_t hash)
+        {
+            for (const KeyIndexPair& entry : mBuckets[hash % mBucketCount])
+                if (entry.key == key) return &mData[entry.index].value;
+
+            return nullptr;
+        }
+        const Val* find_hashed(const Key& key, uint64_t hash) const
+        {
+            for (const KeyIndexPair& entry : mBuckets[hash % mBucketCount])
+                if (entry.key == key) return &mData[entry.index].value;
+
+            return nullptr;
         }
 
     public: // Iterator Methods
@@ -104,13 +161,37 @@ namespace mContainers {
     public: // Element Modifiers
         Val& insert(const Key& key, const Val& val)
         {
-            return Add(key, val);
+            return Add(key, hash_key(key), val);
         }
 
         template<typename... Args>
         Val& emplace(const Key& key, Args&&... args)
         {
-            return Add(key, std::forward<Args>(args)...);
+            return Add(key, hash_key(key), std::forward<Args>(args)...);
+        }
+
+        // insert/emplace with a hash from hash_key()
+        template<typename... Args>
+        Val& insert_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            return Add(key, hash, std::forward<Args>(args)...);
+        }
+
+        // Inserts a value constructed from args unless key is present. Returns the value and whether it was
+        // inserted. The key is hashed and its bucket probed once, growing the table only on insertion.
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            return try_emplace_hashed(key, hash_key(key), std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Val* val = find_hashed(key, hash);
+            if (val) return { val, false };
+
+            return { &Add(key, hash, std::forward<Args>(args)...), true };
         }
 
         void erase(const Key& key)
@@ -129,36 +210,37 @@ namespace mContainers {
 
     private: // Underlying Element Modifier Methods
         // This will cause any existing buckets to become invalidated if a rehashing occurs.
-        Val& Add(const Key& key)
+        // The full hash is kept, so a rehash in between does not hash the key again.
+        Val& Add(const Key& key, uint64_t hash)
         {
             if (((mSize / mBucketCount) >= mMaxLoad) ||
-                (sLimitBucketSize && mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE)) ReHash();
+                (sLimitBucketSize && mBuckets[hash % mBucketCount].size() == MaxBucketSize)) ReHash();
 
             KeyValPair& result = mData.emplace_back(key);
-            mBuckets[Hash(key)].emplace_front(result.key, mSize++);
+            mBuckets[hash % mBucketCount].emplace_front(result.key, mSize++);
 
             return result.value;
         }
 
-        Val& Add(const Key& key, const Val& value)
+        Val& Add(const Key& key, uint64_t hash, const Val& value)
         {
             if (((mSize / mBucketCount) >= mMaxLoad) ||
-                (sLimitBucketSize && mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE)) ReHash();
+                (sLimitBucketSize && mBuckets[hash % mBucketCount].size() == MaxBucketSize)) ReHash();
 
             KeyValPair& result = mData.emplace_back(key, value);
-            mBuckets[Hash(key)].emplace_front(result.key, mSize++);
+            mBuckets[hash % mBucketCount].emplace_front(result.key, mSize++);
 
             return result.value;
         }
 
         template<typename... Args>
-        Val& Add(const Key& key, Args&&... args)
+        Val& Add(const Key& key, uint64_t hash, Args&&... args)
         {
             if ((mSize / mBucketCount) >= mMaxLoad ||
-                (sLimitBucketSize && mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE)) ReHash();
+                (sLimitBucketSize && mBuckets[hash % mBucketCount].size() == MaxBucketSize)) ReHash();
 
             KeyValPair& result = mData.emplace_back(key, std::forward<Args>(args)...);
-            mBuckets[Hash(key)].emplace_front(result.key, mSize++);
+            mBuckets[hash % mBucketCount].emplace_front(result.key, mSize++);
 
             return result.value;
         }
@@ -166,19 +248,25 @@ namespace mContainers {
     private: // Hashing Related Methods
         uint64_t Hash(const Key& key) const
         {
-            return Utils::Hash(key) % mBucketCount;
+            return hash_key(key) % mBucketCount;
         }
         uint64_t Hash(const Key* key) const
         {
             assert(key);
-            return Utils::Hash(*key) % mBucketCount;
+            return hash_key(*key) % mBucketCount;
         }
 
         void ReHash()
         {
+            if (ParallelAllocator && mData.size() >= PARALLEL_REHASH_SIZE && mThreadPool::Get().size() > 1)
+            {
+                ParallelReHash();
+                return;
+            }
+
             mBucketCount = Utils::NextPrime(mBucketCount * 2);
             mBuckets.clear();
-            mBuckets.resize(mBucketCount);
+            mBuckets.resize(mBucketCount, Bucket(allocator()));
 
             for (uint64_t i = 0; i < mData.size(); i++)
             {
@@ -187,6 +275,38 @@ namespace mContainers {
             }
         }
 
+        // Same result as ReHash, but hashing and bucket insertion are spread over the thread pool.
+        // Entries are partitioned by destination bucket range, so each task owns its buckets outright.
+        void ParallelReHash()
+        {
+            mThreadPool& pool = mThreadPool::Get();
+            const uint64_t tasks = pool.size();
+            const uint64_t count = mData.size();
+
+            mBucketCount = Utils::NextPrime(mBucketCount * 2);
+            mBuckets.clear();
+            mBuckets.resize(mBucketCount, Bucket(allocator()));
+
+            mDynArray<uint64_t> bucketOf(count);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t i = count * task / tasks; i < count * (task + 1) / tasks; i++)
+                    bucketOf[i] = Hash(mData[i].key);
+            });
+
+            mDynArray<uint64_t> order, starts;
+            Parallel::PartitionIndices(count, tasks, [&](uint64_t i) { return bucketOf[i] * tasks / mBucketCount; }, order, starts);
+
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t j = starts[task]; j < starts[task + 1]; j++)
+                {
+                    uint64_t i = order[j];
+                    mBuckets[bucketOf[i]].emplace_front(mData[i].key, i);
+                }
+            });
+        }
+
     public:
         void printCollisionDist()
         {
@@ -3,13 +3,14 @@
 #include "mCore.h"
 #include "mList.h"
 #include "mDynArray.h"
+#include "mChunkedArray.h"
 
 #include "mUtils.h"
 
 namespace mContainers {
         
     // Key and Value type must be default constructable for linked list head
-    template<typename Key, typename Val, size_t MaxLoad = 1>
+    template<typename Key, typename Val, size_t MaxLoad = 1, typename Allocator = Memory>
     class OldDictionary
     {
     private:
@@ -53,62 +54,121 @@ namespace mContainers {
     private:
         //using Bucket = std::list<KeyIndexPair>;
 
+        class BucketList;
+
+        // Entries past the first MAX_BUCKET_SIZE spill into blocks of the same size taken from the
+        // BucketList's overflow slabs, so a skewed bucket no longer forces the whole table to rehash.
+        struct OverflowBlock
+        {
+            OverflowBlock* next;
+            alignas(KeyIndexPair) unsigned char storage[sizeof(KeyIndexPair) * MAX_BUCKET_SIZE];
+
+            KeyIndexPair* entries() { return reinterpret_cast<KeyIndexPair*>(storage); }
+        };
+
         class Bucket
         {
         private:
             KeyIndexPair* mData;
+            OverflowBlock* mOverflow;
+            OverflowBlock* mTail;
+            BucketList* mOwner;
             size_t mSize;
 
         public:
-            Bucket(KeyIndexPair* dataBlock) : mData(dataBlock), mSize(0) {}
+            Bucket(KeyIndexPair* dataBlock, BucketList* owner)
+                : mData(dataBlock), mOverflow(nullptr), mTail(nullptr), mOwner(owner), mSize(0) {}
             ~Bucket()
             {
                 for (size_t i = 0; i < mSize; i++)
-                    mData[i].~KeyIndexPair();
+                    Entry(i).~KeyIndexPair();
                 mSize = 0;
             }
 
             template<typename... Args>
             KeyIndexPair& emplace_back(Args&&... args)
             {
-                mAssert(mSize < MAX_BUCKET_SIZE, "Bucket is full!")
+                size_t slot = mSize % MAX_BUCKET_SIZE;
+                KeyIndexPair* block = mData;
+                if (mSize >= MAX_BUCKET_SIZE)
+                {
+                    if (slot == 0)
+                    {
+                        OverflowBlock* overflow = mOwner->AllocOverflow();
+                        if (mTail) mTail->next = overflow;
+                        else mOverflow = overflow;
+                        mTail = overflow;
+                    }
+                    block = mTail->entries();
+                }
 
-                new(&mData[mSize]) KeyIndexPair(std::forward<Args>(args)...);
-                return mData[mSize++];
+                new(&block[slot]) KeyIndexPair(std::forward<Args>(args)...);
+                mSize++;
+                return block[slot];
             }
 
             KeyIndexPair& operator[](size_t index)
             {
                 mAssert(index < mSize, "Accessing unitialised entry!");
 
-                return mData[index];
+                return Entry(index);
             }
             const KeyIndexPair& operator[](size_t index) const
             {
-                mAssert(index < size, "Accessing unitialised entry!");
+                mAssert(index < mSize, "Accessing unitialised entry!");
 
-                return mData[index];
+                return const_cast<Bucket*>(this)->Entry(index);
             }
 
             KeyIndexPair* find(const Key& other)
             {
-                for (size_t i = 0; i < mSize; i++)
+                size_t count = mSize < MAX_BUCKET_SIZE ? mSize : MAX_BUCKET_SIZE;
+                for (size_t i = 0; i < count; i++)
                     if (mData[i].key == other) return &mData[i];
 
+                size_t remaining = mSize - count;
+                for (OverflowBlock* block = mOverflow; block; block = block->next)
+                {
+                    count = remaining < MAX_BUCKET_SIZE ? remaining : MAX_BUCKET_SIZE;
+                    for (size_t i = 0; i < count; i++)
+                        if (block->entries()[i].key == other) return &block->entries()[i];
+                    remaining -= count;
+                }
+
                 return nullptr;
             }
+            const KeyIndexPair* find(const Key& other) const
+            {
+                return const_cast<Bucket*>(this)->find(other);
+            }
 
             size_t size() const { return mSize; }
+
+        private:
+            KeyIndexPair& Entry(size_t index)
+            {
+                if (index < MAX_BUCKET_SIZE) return mData[index];
+
+                OverflowBlock* block = mOverflow;
+                for (index -= MAX_BUCKET_SIZE; index >= MAX_BUCKET_SIZE; index -= MAX_BUCKET_SIZE)
+                    block = block->next;
+
+                return block->entries()[index];
+            }
         };
     
-        class BucketList
+        class BucketList : private mAllocatorStorage<Allocator>
         {
         public:
-            BucketList(size_t count = DEFAULT_BUCKETS)
+            BucketList(const Allocator& allocator = Allocator(), size_t count = DEFAULT_BUCKETS)
+                : mAllocatorStorage<Allocator>(allocator), mSlabs(allocator)
             {
                 Build(count);
             }
 
+            BucketList(const BucketList&) = delete;
+            BucketList& operator=(const BucketList&) = delete;
+
             ~BucketList()
             {
                 Reset();
@@ -133,21 +193,38 @@ namespace mContainers {
                 Build(count);
             }
 
+            // Overflow blocks are handed out from slabs and only returned all at once by a resize
+            OverflowBlock* AllocOverflow()
+            {
+                if (mSlabUsed == mSlabSize)
+                {
+                    mSlabs.emplace_back(this->template Allocate<OverflowBlock>(mSlabSize));
+                    mSlabUsed = 0;
+                }
+
+                OverflowBlock* block = &mSlabs[mSlabs.size() - 1][mSlabUsed++];
+                block->next = nullptr;
+                return block;
+            }
+
             size_t count() const { return mBucketCount; }
 
         private:
             void Build(size_t count)
             {
                 mBucketCount = count;
-                mBuckets = Memory::Alloc<Bucket>(mBucketCount);
-                mBase = Memory::Alloc<KeyIndexPair>(mBucketCount * MAX_BUCKET_SIZE);
+                mBuckets = this->template Allocate<Bucket>(mBucketCount);
+                mBase = this->template Allocate<KeyIndexPair>(mBucketCount * MAX_BUCKET_SIZE);
 
                 KeyIndexPair* bucketBlock = mBase;
                 for (size_t i = 0; i < mBucketCount; i++)
                 {
-                    Memory::Emplace<Bucket>(&mBuckets[i], bucketBlock);
+                    Memory::Emplace<Bucket>(&mBuckets[i], bucketBlock, this);
                     bucketBlock += MAX_BUCKET_SIZE;
                 }
+
+                mSlabSize = mBucketCount / 16 > 16 ? mBucketCount / 16 : 16;
+                mSlabUsed = mSlabSize;
             }
 
             void Reset()
@@ -155,50 +232,92 @@ namespace mContainers {
                 for (size_t i = 0; i < mBucketCount; i++)
                     mBuckets[i].~Bucket();
 
-                Memory::Free<Bucket>(mBuckets, mBucketCount);
-                Memory::Free<KeyIndexPair>(mBase, mBucketCount * MAX_BUCKET_SIZE);
+                this->template Deallocate<Bucket>(mBuckets, mBucketCount);
+                this->template Deallocate<KeyIndexPair>(mBase, mBucketCount * MAX_BUCKET_SIZE);
+
+                for (size_t i = 0; i < mSlabs.size(); i++)
+                    this->template Deallocate<OverflowBlock>(mSlabs[i], mSlabSize);
+                mSlabs.clear();
             }
 
         private:
             KeyIndexPair* mBase;
             Bucket* mBuckets;
             size_t mBucketCount;
+            mDynArray<OverflowBlock*, Allocator> mSlabs;
+            size_t mSlabSize;
+            size_t mSlabUsed;
         };
 
     private:
-        mDynArray<KeyValPair> mData;
+        mChunkedArray<KeyValPair, 256, Allocator> mData; // Stable, buckets refer to the keys in place
         BucketList mBuckets; // Custom Allocator
         size_t mSize;
         size_t mBucketCount;
         size_t mMaxLoad;
     
     public:
-        OldDictionary()
-            : mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+        OldDictionary(const Allocator& allocator = Allocator())
+            : mData(allocator), mBuckets(allocator), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+
+        // The buckets refer to keys in mData, so they are rebuilt over the copied entries
+        OldDictionary(const OldDictionary& other)
+            : mData(other.mData), mBuckets(other.allocator(), other.mBucketCount), mSize(other.mSize),
+            mBucketCount(other.mBucketCount), mMaxLoad(other.mMaxLoad)
+        {
+            Index();
+        }
+
+        OldDictionary& operator=(const OldDictionary& other)
+        {
+            if (this == &other) return *this;
+
+            mData = other.mData;
+            mSize = other.mSize;
+            mBucketCount = other.mBucketCount;
+            mMaxLoad = other.mMaxLoad;
+            mBuckets.resize(mBucketCount);
+            Index();
+            return *this;
+        }
+
+        const Allocator& allocator() const { return mData.allocator(); }
+
+        size_t size() const { return mSize; }
+        size_t bucketCount() const { return mBucketCount; }
         
     public: // Access Operators
         Val& operator[](const Key& key)
         {
-            Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
-
-            if (bucket.size() == 0) return Add(key);
-
-            KeyIndexPair* it = bucket.find(key);
-            if (it) return mData[it->index].value;
-            
-            return Add(key);
+            return *try_emplace(key).first;
         }
         
         const Val& operator[](const Key& key) const
         {
-            const Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
-            
-            mAssert(bucket.size() == 0, "Bucket is empty!");
-            
-            const KeyIndexPair it = bucket.find(key);
-            mAssert(it, "Key not in hash table!");
-            
-            return it->value;
+            const Val* val = find(key);
+            mAssert(val, "Key not in hash table!");
+
+            return *val;
+        }
+
+        // Lookups that never insert
+        Val* find(const Key& key) { return find_hashed(key, hash_key(key)); }
+        const Val* find(const Key& key) const { return find_hashed(key, hash_key(key)); }
+        bool contains(const Key& key) const { return find(key) != nullptr; }
+
+        // Full hash of a key. Callers probing several tables for the same key can hash it once and pass
+        // the result to the *_hashed methods of each.
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        Val* find_hashed(const Key& key, uint64_t hash)
+        {
+            KeyIndexPair* it = mBuckets[hash % mBucketCount].find(key);
+            return it ? &mData[it->index].value : nullptr;
+        }
+        const Val* find_hashed(const Key& key, uint64_t hash) const
+        {
+            const KeyIndexPair* it = mBuckets[hash % mBucketCount].find(key);
+            return it ? &mData[it->index].value : nullptr;
         }
         
     public: // Iterator Methods
@@ -209,41 +328,65 @@ namespace mContainers {
         
     public: // Element Modifiers
         Val& insert(const Key& key, const Val& val)
-        { return Add(key, val); }
+        { return Add(key, hash_key(key), val); }
         
         template<typename... Args>
         Val& emplace(const Key& key, Args&&... args)
-        { return Add(key, std::forward<Args>(args)...); }
+        { return Add(key, hash_key(key), std::forward<Args>(args)...); }
+
+        // insert/emplace with a hash from hash_key()
+        template<typename... Args>
+        Val& insert_hashed(const Key& key, uint64_t hash, Args&&... args)
+        { return Add(key, hash, std::forward<Args>(args)...); }
+
+        // Inserts a value constructed from args unless key is present. Returns the value and whether it was
+        // inserted. The key is hashed and its bucket probed once, growing the table only on insertion.
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            return try_emplace_hashed(key, hash_key(key), std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Val* val = find_hashed(key, hash);
+            if (val) return { val, false };
+
+            return { &Add(key, hash, std::forward<Args>(args)...), true };
+        }
 
     private: // Underlying Element Modifier Methods
         // This will cause any existing buckets to become invalidated if a rehashing occurs.
-        Val& Add(const Key& key)
+        // Growth only depends on the overall load, full buckets spill into overflow blocks.
+        // The full hash is kept, so a rehash in between does not hash the key again.
+        Val& Add(const Key& key, uint64_t hash)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad || mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
 
             KeyValPair& result = mData.emplace_back(key);
-            mBuckets[Hash(key)].emplace_back(result.key, mSize++);
+            mBuckets[hash % mBucketCount].emplace_back(result.key, mSize++);
 
             return result.value;
         }
 
-        Val& Add(const Key& key, const Val& value)
+        Val& Add(const Key& key, uint64_t hash, const Val& value)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad || mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
 
             KeyValPair& result = mData.emplace_back(key, value);
-            mBuckets[Hash(key)].emplace_back(result.key, mSize++);
+            mBuckets[hash % mBucketCount].emplace_back(result.key, mSize++);
 
             return result.value;
         }
 
         template<typename... Args>
-        Val& Add(const Key& key, Args&&... args)
+        Val& Add(const Key& key, uint64_t hash, Args&&... args)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad || mBuckets[Hash(key)].size() == MAX_BUCKET_SIZE) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
 
             KeyValPair& result = mData.emplace_back(key, std::forward<Args>(args)...);
-            mBuckets[Hash(key)].emplace_back(result.key, mSize++); // Custom Allocator
+            mBuckets[hash % mBucketCount].emplace_back(result.key, mSize++); // Custom Allocator
 
             return result.value;
         }
@@ -251,19 +394,24 @@ namespace mContainers {
     private: // Hashing Related Methods
         size_t Hash(const Key& key) const
         {
-            return Utils::Hash(key) % mBucketCount;
+            return hash_key(key) % mBucketCount;
         }
         size_t Hash(const Key* key) const
         {
             mAssert(key, "Key must not be null!");
-            return Utils::Hash(*key) % mBucketCount;
+            return hash_key(*key) % mBucketCount;
         }
         
         void ReHash() 
         {
             mBucketCount = Utils::NextPrime(mBucketCount * 2);
             mBuckets.resize(mBucketCount);
+            Index();
+        }
 
+        // Adds every entry to the (empty) buckets
+        void Index()
+        {
             for (size_t i = 0; i < mData.size(); i++)
             {
                 const Key& key = mData[i].key;
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mSpan.h"
+#include "mDictionary.h"
+#include "mThreadPool.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+    namespace Aggregate {
+
+        static constexpr uint64_t NoEntry = (uint64_t)-1;
+
+        // Linear probing index over dense key/value/hash arrays. Holds the per-thread partial results and the
+        // per-partition merged results, each key is hashed once up front and the hash travels with it.
+        template<typename Key, typename Val>
+        class PartialTable
+        {
+        public:
+            mDynArray<Key> keys;
+            mDynArray<Val> values;
+            mDynArray<uint64_t> hashes;
+
+        private:
+            mDynArray<uint64_t> mSlots;
+            uint64_t mMask;
+
+        public:
+            PartialTable()
+                : mSlots(16, NoEntry), mMask(15) {}
+
+            template<typename Reducer>
+            void Accumulate(const Key& key, const Val& value, uint64_t hash, Reducer& reduce)
+            {
+                uint64_t slot = hash & mMask;
+                for (uint64_t index; (index = mSlots[slot]) != NoEntry; slot = (slot + 1) & mMask)
+                {
+                    if (hashes[index] == hash && keys[index] == key)
+                    {
+                        reduce(values[index], value);
+                        return;
+                    }
+                }
+
+                // Keep the index at most half full
+                if ((keys.size() + 1) * 2 > mMask + 1)
+                {
+                    Grow();
+                    for (slot = hash & mMask; mSlots[slot] != NoEntry; slot = (slot + 1) & mMask) {}
+                }
+
+                mSlots[slot] = keys.size();
+                keys.emplace_back(key);
+                values.emplace_back(value);
+                hashes.emplace_back(hash);
+            }
+
+            uint64_t size() const { return keys.size(); }
+
+        private:
+            void Grow()
+            {
+                mMask = mMask * 2 + 1;
+                mSlots.clear();
+                mSlots.resize(mMask + 1, NoEntry);
+
+                for (uint64_t i = 0; i < keys.size(); i++)
+                {
+                    uint64_t slot = hashes[i] & mMask;
+                    while (mSlots[slot] != NoEntry)
+                        slot = (slot + 1) & mMask;
+
+                    mSlots[slot] = i;
+                }
+            }
+        };
+
+        // Partitions are picked from the top bits of the mixed hash, the tables above index with the low bits
+        inline uint64_t Partition(uint64_t hash, uint32_t bits)
+        {
+            return bits == 0 ? 0 : (hash * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+        }
+
+    }
+
+    // Combines the values of every key in the batch with reduce(Val& accumulated, const Val& value) and returns
+    // one entry per distinct key. The reducer must be associative and commutative, and is called from several
+    // threads at once for large batches. Each thread first aggregates its slice of the batch into a private
+    // table, the partial results are then split by hash prefix and every partition is merged by one thread.
+    template<typename Key, typename Val, typename Reducer>
+    mDictionary<Key, Val> ReduceByKey(mSpan<const Key> keys, mSpan<const Val> values, Reducer&& reduce)
+    {
+        mAssert(keys.size() == values.size(), "Every key needs a value!");
+
+        mThreadPool& pool = mThreadPool::Get();
+        const uint64_t count = keys.size();
+        const uint64_t tasks = count >= PARALLEL_AGGREGATE_SIZE ? pool.size() : 1;
+
+        // A few partitions per thread so uneven partitions still balance out
+        uint32_t bits = 0;
+        while (tasks > 1 && ((uint64_t)1 << bits) < tasks * 4)
+            bits++;
+        const uint64_t partitions = (uint64_t)1 << bits;
+
+        using Table = Aggregate::PartialTable<Key, Val>;
+
+        // Local aggregation, then a counting sort of each local table by partition
+        mDynArray<Table> local(tasks);
+        mDynArray<mDynArray<uint64_t>> order(tasks);
+        mDynArray<uint64_t> starts(tasks * (partitions + 1), 0); // [task][partition]
+        pool.run(tasks, [&](uint64_t task)
+        {
+            Table& table = local[task];
+            for (uint64_t i = count * task / tasks; i < count * (task + 1) / tasks; i++)
+                table.Accumulate(keys[i], values[i], Utils::Hash(keys[i]), reduce);
+
+            uint64_t* offsets = &starts[task * (partitions + 1)];
+            for (uint64_t i = 0; i < table.size(); i++)
+                offsets[Aggregate::Partition(table.hashes[i], bits) + 1]++;
+            for (uint64_t p = 0; p < partitions; p++)
+                offsets[p + 1] += offsets[p];
+
+            mDynArray<uint64_t> next(partitions);
+            for (uint64_t p = 0; p < partitions; p++)
+                next[p] = offsets[p];
+
+            order[task].resize(table.size());
+            for (uint64_t i = 0; i < table.size(); i++)
+                order[task][next[Aggregate::Partition(table.hashes[i], bits)]++] = i;
+        });
+
+        // Each partition gathers its slice of every local table. A single local table is already complete.
+        mDynArray<Table> merged(tasks == 1 ? 0 : partitions);
+        if (tasks == 1) merged.swap(local);
+        else pool.run(partitions, [&](uint64_t partition)
+        {
+            Table& table = merged[partition];
+            for (uint64_t task = 0; task < tasks; task++)
+            {
+                const Table& source = local[task];
+                const uint64_t* offsets = &starts[task * (partitions + 1)];
+                for (uint64_t j = offsets[partition]; j < offsets[partition + 1]; j++)
+                {
+                    uint64_t i = order[task][j];
+                    table.Accumulate(source.keys[i], source.values[i], source.hashes[i], reduce);
+                }
+            }
+        });
+
+        uint64_t total = 0;
+        for (uint64_t p = 0; p < partitions; p++)
+            total += merged[p].size();
+
+        mDictionary<Key, Val> result;
+        result.reserve(total);
+        for (uint64_t p = 0; p < partitions; p++)
+            for (uint64_t i = 0; i < merged[p].size(); i++)
+                result.insert_hashed(merged[p].keys[i], merged[p].hashes[i], merged[p].values[i]);
+
+        return result;
+    }
+
+    template<typename Key, typename Val, typename Reducer>
+    mDictionary<Key, Val> ReduceByKey(const mDynArray<Key>& keys, const mDynArray<Val>& values, Reducer&& reduce)
+    {
+        return ReduceByKey(mSpan<const Key>(keys), mSpan<const Val>(values), std::forward<Reducer>(reduce));
+    }
+
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "mCore.h"
+#include "mSimd.h"
 
 namespace mContainers {
 
@@ -28,7 +29,7 @@ namespace mContainers {
 		mBlockIterator operator++(int)
 		{
 			mBlockIterator temp = *this;
-			temp++;
+			++(*this);
 			return temp;
 		}
 
@@ -40,7 +41,7 @@ namespace mContainers {
 		mBlockIterator operator--(int)
 		{
 			mBlockIterator temp = *this;
-			temp--;
+			--(*this);
 			return temp;
 		}
 
@@ -108,7 +109,7 @@ namespace mContainers {
 		using ValType = T;
 
 	private:
-		template<typename U>
+		template<typename U, typename Allocator, typename GrowthPolicy>
 		friend class mDynArray;
 
 		T* mData;
@@ -149,10 +150,10 @@ namespace mContainers {
 			mSize = 0;
 		}
 
-	protected:
+	public:
 		T* data() { return mData; }
+		const T* data() const { return mData; }
 
-	public:
 		T& operator[](uint64_t index)
 		{
 			assert(index < mSize);
@@ -188,11 +189,29 @@ namespace mContainers {
 			return it;
 		}
 
+		// Vectorised for arithmetic, enum and pointer elements, see mSimd.h
 		Iterator find(const T& value)
 		{
-			return find(begin(), end(), value);
+			return Iterator(mData + Simd::Find(mData, mSize, value));
 		}
 
+		uint64_t count(const T& value) const { return Simd::Count(mData, mSize, value); }
+		bool contains(const T& value) const { return Simd::Find(mData, mSize, value) != mSize; }
+
+		// First element equal to any of values
+		Iterator find_if_equal_any(const T* values, uint64_t valueCount)
+		{
+			return Iterator(mData + Simd::FindAny(mData, mSize, values, valueCount));
+		}
+		Iterator find_if_equal_any(std::initializer_list<T> values)
+		{
+			return find_if_equal_any(values.begin(), values.size());
+		}
+
+		// Smallest and largest element by operator<, the block must not be empty
+		T min() const { return Simd::Min(mData, mSize); }
+		T max() const { return Simd::Max(mData, mSize); }
+
 		Iterator begin()
 		{
 			return Iterator(mData);
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+namespace mContainers {
+
+	template<typename mChunkedArray>
+	class mChunkedIterator
+	{
+	public:
+		using TypeVal = typename mChunkedArray::ValType;
+		using TypeRef = typename mChunkedArray::ValType&;
+		using TypePtr = typename mChunkedArray::ValType*;
+
+	private:
+		const mChunkedArray* mArray;
+		uint64_t mIndex;
+		TypePtr mPtr;
+
+	public:
+		mChunkedIterator(const mChunkedArray* array, uint64_t index)
+			: mArray(array), mIndex(index), mPtr(index < array->size() ? array->Address(index) : nullptr) {}
+
+		// Steps within a chunk are a pointer increment, the directory is only read when crossing into the next one
+		mChunkedIterator& operator++()
+		{
+			if (++mIndex % mChunkedArray::ChunkCapacity == 0)
+				mPtr = mIndex < mArray->size() ? mArray->Address(mIndex) : nullptr;
+			else
+				mPtr++;
+
+			return *this;
+		}
+		mChunkedIterator operator++(int)
+		{
+			mChunkedIterator it = *this;
+			++(*this);
+			return it;
+		}
+
+		TypePtr operator->() { return mPtr; }
+		TypeRef operator*() { return *mPtr; }
+
+		bool operator== (const mChunkedIterator& other) const
+		{
+			return mIndex == other.mIndex;
+		}
+		bool operator!= (const mChunkedIterator& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	// Array of fixed size chunks reached through a directory of chunk pointers. Elements never move once
+	// added, so pointers and references to them stay valid until they are popped or the array is cleared.
+	// Indexing is a shift and a mask, appending never copies existing elements and growth only extends the
+	// directory. ChunkSize must be a power of two.
+	template<typename T, uint64_t ChunkSize = 256, typename Allocator = Memory>
+	class mChunkedArray : private mAllocatorStorage<Allocator>
+	{
+	public:
+		using VecType = mChunkedArray<T, ChunkSize, Allocator>;
+		using Iterator = mChunkedIterator<VecType>;
+		using ValType = T;
+		using AllocatorType = Allocator;
+
+		static constexpr uint64_t ChunkCapacity = ChunkSize;
+
+	private:
+		mStaticAssert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "Chunk size must be a power of two!")
+
+		using Storage = mAllocatorStorage<Allocator>;
+
+		template<typename Array>
+		friend class mChunkedIterator;
+
+		mDynArray<T*, Allocator> mChunks;
+		uint64_t mSize;
+
+	public:
+		mChunkedArray()
+			: mSize(0) {}
+
+		explicit mChunkedArray(const Allocator& allocator)
+			: Storage(allocator), mChunks(allocator), mSize(0) {}
+
+		mChunkedArray(const mChunkedArray& other)
+			: Storage(other.allocator()), mChunks(other.allocator()), mSize(0)
+		{
+			reserve(other.mSize);
+			for (uint64_t i = 0; i < other.mSize; i++)
+				emplace_back(other[i]);
+		}
+
+		mChunkedArray(mChunkedArray&& other)
+			: Storage(other.allocator()), mChunks(other.allocator()), mSize(0)
+		{
+			swap(other);
+		}
+
+		~mChunkedArray()
+		{
+			clear();
+			for (uint64_t i = 0; i < mChunks.size(); i++)
+				this->template Deallocate<T>(mChunks[i], ChunkSize);
+		}
+
+		mChunkedArray& operator=(const mChunkedArray& other)
+		{
+			if (this == &other) return *this;
+
+			mChunkedArray copy(other);
+			swap(copy);
+			return *this;
+		}
+		mChunkedArray& operator=(mChunkedArray&& other)
+		{
+			swap(other);
+			return *this;
+		}
+
+		void swap(mChunkedArray& other)
+		{
+			mChunks.swap(other.mChunks);
+			std::swap(mSize, other.mSize);
+			std::swap(allocator(), other.allocator());
+		}
+
+		using Storage::allocator;
+
+	public: // Access Operators
+		T& operator[](uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return *Address(index);
+		}
+		const T& operator[](uint64_t index) const
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return *Address(index);
+		}
+
+		T& back() { return (*this)[mSize - 1]; }
+		const T& back() const { return (*this)[mSize - 1]; }
+
+	public: // Element Modifiers
+		void push_back(const T& value) { emplace_back(value); }
+		void push_back(T&& value) { emplace_back(std::move(value)); }
+
+		// Existing elements are never touched, value may refer to one of them
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if (mSize == capacity()) AddChunk();
+
+			T* slot = Address(mSize);
+			Memory::Emplace<T>(slot, std::forward<Args>(args)...);
+			mSize++;
+
+			return *slot;
+		}
+
+		void pop_back()
+		{
+			mAssert(mSize > 0, "Pop from an empty array!");
+
+			Address(--mSize)->~T();
+		}
+
+		// Destroys the elements, the chunks are kept for reuse
+		void clear()
+		{
+			for (uint64_t i = 0; i < mSize; i++)
+				Address(i)->~T();
+
+			mSize = 0;
+		}
+
+		void reserve(uint64_t count)
+		{
+			mChunks.reserve((count + ChunkSize - 1) / ChunkSize);
+			while (capacity() < count)
+				AddChunk();
+		}
+
+	public: // Iterator Methods
+		Iterator begin() { return Iterator(this, 0); }
+		const Iterator begin() const { return Iterator(this, 0); }
+		Iterator end() { return Iterator(this, mSize); }
+		const Iterator end() const { return Iterator(this, mSize); }
+
+		// Calls fn(elements, count) for each chunk in order, for loops that want a plain pointer range
+		template<typename Fn>
+		void forEachChunk(Fn&& fn)
+		{
+			for (uint64_t i = 0; i * ChunkSize < mSize; i++)
+				fn(mChunks[i], mSize - i * ChunkSize < ChunkSize ? mSize - i * ChunkSize : ChunkSize);
+		}
+
+	public:
+		uint64_t size() const { return mSize; }
+		uint64_t capacity() const { return mChunks.size() * ChunkSize; }
+		uint64_t chunkCount() const { return mChunks.size(); }
+		bool empty() const { return mSize == 0; }
+
+	private:
+		T* Address(uint64_t index) const { return mChunks[index / ChunkSize] + index % ChunkSize; }
+
+		void AddChunk()
+		{
+			mChunks.emplace_back(this->template Allocate<T>(ChunkSize));
+		}
+	};
+
+}
\ No newline at end of file
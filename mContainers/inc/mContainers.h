@@ -2,6 +2,24 @@
 
 #include "mDictionary.h"
 #include "mDynArray.h"
+#include "mFlatMap.h"
 #include "mList.h"
+#include "mRadixTree.h"
+#include "mMultiDictionary.h"
+#include "mSpan.h"
+#include "mSnapshotDictionary.h"
+#include "mThreadPool.h"
+#include "mHashSet.h"
+#include "mAggregate.h"
+#include "mPersistentDictionary.h"
+#include "mCounterMap.h"
+#include "mLinearDictionary.h"
+#include "mSlotMap.h"
+#include "mSparseSet.h"
+#include "mSmallArray.h"
+#include "mChunkedArray.h"
+#include "mSimd.h"
+#include "mParallel.h"
+#include "mSoAArray.h"
 #include "mVector.h"
 #include "mMatrix.h"
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "../mpch.h"
 
+#include <type_traits>
+
 #if !defined(NDEBUG)
 #define M_DEBUG
 #endif
@@ -31,6 +33,17 @@
 #define M_STRINGIFY_MACRO(x) #x
 #define M_NOT_USED(x) ((void)(x))
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define M_SIMD_SSE2
+#endif
+
+#if defined(_MSC_VER)
+	#include <xmmintrin.h>
+	#define M_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+	#define M_PREFETCH(addr) __builtin_prefetch(addr)
+#endif
+
 #define	mMaxFloat		FLT_MAX
 #define mEpsilon		FLT_EPSILON
 #define mPi				3.14159265359f
@@ -43,6 +56,16 @@
 #define LOAD_SCALE      2
 #define MAX_BUCKET_SIZE 5
 #define DEFAULT_SEED	64687421
+#define PARALLEL_REHASH_SIZE 65536 // Tables at least this large rehash on the shared thread pool
+#define PARALLEL_SET_SIZE 65536 // Set operations over sets at least this large run on the shared thread pool
+#define PARALLEL_AGGREGATE_SIZE 65536 // Batches at least this large aggregate on the shared thread pool
+#define PARALLEL_GRAIN 16384 // Fewest elements per task for the parallel algorithms, smaller inputs run serially
+
+// Array Default Parameters
+#define DYNARRAY_MAP_SIZE (1ull << 21) // Relocatable arrays at least this many bytes are mmap backed and grow with mremap (Linux)
+
+// Persistence Default Parameters
+#define PERSIST_SYNC_RECORDS 256 // Logged mutations per group commit (one fdatasync)
 
 //Client log macros
 #define M_TRACE(...)			::mContainers::mLog::GetLogger()->trace(__VA_ARGS__)
@@ -204,4 +227,49 @@ namespace mContainers {
 
 	};
 
+	// Types that can be moved to a new address with a plain memcpy, leaving nothing to destroy at the old one.
+	// Specialise for types that own resources but hold no pointers into themselves.
+	template<typename T>
+	struct mIsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+	// Allocator of a container, which inherits from this privately. An allocator provides Alloc<T>(count) and
+	// Free<T>(data, count) like Memory, either static or per instance (arenas, pools, NUMA-local heaps).
+	// Empty allocators are inherited so they take no space in the container, others are kept as a member.
+	template<typename Allocator, bool Empty = std::is_empty_v<Allocator> && !std::is_final_v<Allocator>>
+	class mAllocatorStorage : public Allocator
+	{
+	public:
+		mAllocatorStorage(const Allocator& allocator = Allocator())
+			: Allocator(allocator) {}
+
+		Allocator& allocator() { return *this; }
+		const Allocator& allocator() const { return *this; }
+
+	protected:
+		template<typename T>
+		T* Allocate(uint64_t count) { return allocator().template Alloc<T>(count); }
+		template<typename T>
+		void Deallocate(T* data, uint64_t count) { allocator().template Free<T>(data, count); }
+	};
+
+	template<typename Allocator>
+	class mAllocatorStorage<Allocator, false>
+	{
+	private:
+		Allocator mAllocator;
+
+	public:
+		mAllocatorStorage(const Allocator& allocator = Allocator())
+			: mAllocator(allocator) {}
+
+		Allocator& allocator() { return mAllocator; }
+		const Allocator& allocator() const { return mAllocator; }
+
+	protected:
+		template<typename T>
+		T* Allocate(uint64_t count) { return mAllocator.template Alloc<T>(count); }
+		template<typename T>
+		void Deallocate(T* data, uint64_t count) { mAllocator.template Free<T>(data, count); }
+	};
+
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+    // Concurrent map from keys to integer counters, for metrics and other increment-heavy tables. Looking up an
+    // existing key takes no locks: the index is an open addressing table of entry pointers that is only ever
+    // replaced whole, and each counter sits on its own cache line so threads bumping different keys never share
+    // one. New keys go through a mutex. Entries are never moved or freed before the map, so counter() handles
+    // stay valid for its lifetime; retired index tables are also kept until then (their total is below the
+    // size of the live one). The allocator is only called under the insert mutex, so it needs no locking.
+    template<typename Key, typename Counter = int64_t, typename Allocator = Memory>
+    class mCounterMap : private mAllocatorStorage<Allocator>
+    {
+    private:
+        using Storage = mAllocatorStorage<Allocator>;
+
+        mStaticAssert(std::is_integral_v<Counter>, "Counters must be an integer type!")
+
+        static constexpr uint64_t SegmentSize = 256;
+
+        struct alignas(64) Entry
+        {
+            std::atomic<Counter> value;
+            uint64_t hash;
+            Key key;
+
+            Entry(const Key& _key, uint64_t _hash)
+                : value(0), hash(_hash), key(_key) {}
+        };
+
+        // Allocators don't promise more than the default alignment, so segments get room to align the entries
+        static constexpr uint64_t SegmentBytes = SegmentSize * sizeof(Entry) + alignof(Entry) - 1;
+
+        struct Table
+        {
+            uint64_t mask;
+            std::atomic<Entry*>* slots;
+
+            Table(uint64_t _mask, std::atomic<Entry*>* _slots)
+                : mask(_mask), slots(_slots) {}
+        };
+
+    public:
+        struct Sample
+        {
+            Key key;
+            Counter value;
+
+            Sample() : key(), value(0) {}
+            Sample(const Key& _key, Counter _value)
+                : key(_key), value(_value) {}
+        };
+
+    private:
+        std::atomic<Table*> mTable;
+        std::atomic<uint64_t> mSize;
+        std::mutex mMutex;              // Taken by inserts and snapshots only
+        mDynArray<uint8_t*, Allocator> mSegments;   // Entries in insertion order, SegmentSize per segment
+        mDynArray<Table*, Allocator> mRetired;
+
+    public:
+        mCounterMap(const Allocator& allocator = Allocator())
+            : Storage(allocator), mTable(nullptr), mSize(0), mSegments(allocator), mRetired(allocator)
+        {
+            mTable.store(NewTable(16));
+        }
+
+        mCounterMap(const mCounterMap&) = delete;
+
+        ~mCounterMap()
+        {
+            uint64_t size = mSize.load();
+            for (uint64_t i = 0; i < size; i++)
+                EntryAt(i).~Entry();
+            for (uint64_t i = 0; i < mSegments.size(); i++)
+                this->template Deallocate<uint8_t>(mSegments[i], SegmentBytes);
+
+            for (uint64_t i = 0; i < mRetired.size(); i++)
+                FreeTable(mRetired[i]);
+            FreeTable(mTable.load());
+        }
+
+        using Storage::allocator;
+
+    public: // Access Operators
+        // Counter for key, created at zero if missing. Hot loops can keep the reference to skip hashing.
+        std::atomic<Counter>& counter(const Key& key)
+        {
+            uint64_t hash = Utils::Hash(key);
+            Entry* entry = Find(key, hash);
+            if (!entry) entry = Insert(key, hash);
+
+            return entry->value;
+        }
+
+        Counter add(const Key& key, Counter delta = 1)
+        {
+            return counter(key).fetch_add(delta, std::memory_order_relaxed) + delta;
+        }
+
+        // Current value, zero for keys that were never added. Does not create the key.
+        Counter get(const Key& key) const
+        {
+            Entry* entry = Find(key, Utils::Hash(key));
+            return entry ? entry->value.load(std::memory_order_relaxed) : 0;
+        }
+
+        bool contains(const Key& key) const { return Find(key, Utils::Hash(key)) != nullptr; }
+
+        uint64_t size() const { return mSize.load(std::memory_order_acquire); }
+
+    public: // Iterator Methods
+        // Every key with its counter, in insertion order. The key set is exact (inserts wait for the
+        // snapshot), each counter is read atomically but increments keep running while they are read.
+        mDynArray<Sample> snapshot()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            uint64_t size = mSize.load(std::memory_order_relaxed);
+            mDynArray<Sample> samples;
+            samples.reserve(size);
+            for (uint64_t i = 0; i < size; i++)
+            {
+                Entry& entry = EntryAt(i);
+                samples.emplace_back(entry.key, entry.value.load(std::memory_order_relaxed));
+            }
+
+            return samples;
+        }
+
+    private: // Hashing Related Methods
+        Entry* Find(const Key& key, uint64_t hash) const
+        {
+            const Table* table = mTable.load(std::memory_order_acquire);
+            for (uint64_t slot = hash & table->mask;; slot = (slot + 1) & table->mask)
+            {
+                Entry* entry = table->slots[slot].load(std::memory_order_acquire);
+                if (!entry) return nullptr;
+                if (entry->hash == hash && entry->key == key) return entry;
+            }
+        }
+
+        Entry* Insert(const Key& key, uint64_t hash)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            // Another thread may have added it since the lock free miss
+            if (Entry* entry = Find(key, hash)) return entry;
+
+            uint64_t size = mSize.load(std::memory_order_relaxed);
+            Table* table = mTable.load(std::memory_order_relaxed);
+            if ((size + 1) * 2 > table->mask + 1) table = Grow(table, size);
+
+            if (size % SegmentSize == 0)
+                mSegments.emplace_back(this->template Allocate<uint8_t>(SegmentBytes));
+
+            Entry* entry = Memory::Emplace<Entry>(&EntryAt(size), key, hash);
+            Place(table, entry, std::memory_order_release);
+            mSize.store(size + 1, std::memory_order_release);
+
+            return entry;
+        }
+
+        // Builds a table twice the size off to the side and publishes it. Readers still probing the old
+        // table find every entry it held, the old table is kept until the map is destroyed.
+        Table* Grow(Table* table, uint64_t size)
+        {
+            Table* grown = NewTable((table->mask + 1) * 2);
+            for (uint64_t i = 0; i < size; i++)
+                Place(grown, &EntryAt(i), std::memory_order_relaxed);
+
+            mRetired.emplace_back(table);
+            mTable.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        static void Place(Table* table, Entry* entry, std::memory_order order)
+        {
+            uint64_t slot = entry->hash & table->mask;
+            while (table->slots[slot].load(std::memory_order_relaxed))
+                slot = (slot + 1) & table->mask;
+
+            table->slots[slot].store(entry, order);
+        }
+
+        Table* NewTable(uint64_t capacity)
+        {
+            std::atomic<Entry*>* slots = this->template Allocate<std::atomic<Entry*>>(capacity);
+            for (uint64_t i = 0; i < capacity; i++)
+                Memory::Emplace<std::atomic<Entry*>>(&slots[i], nullptr);
+
+            return Memory::Emplace<Table>(this->template Allocate<Table>(1), capacity - 1, slots);
+        }
+
+        void FreeTable(Table* table)
+        {
+            this->template Deallocate<std::atomic<Entry*>>(table->slots, table->mask + 1);
+            this->template Deallocate<Table>(table, 1);
+        }
+
+        Entry& EntryAt(uint64_t index)
+        {
+            uintptr_t segment = reinterpret_cast<uintptr_t>(mSegments[index / SegmentSize]);
+            Entry* entries = reinterpret_cast<Entry*>((segment + alignof(Entry) - 1) & ~uintptr_t(alignof(Entry) - 1));
+
+            return entries[index % SegmentSize];
+        }
+    };
+
+}
\ No newline at end of file
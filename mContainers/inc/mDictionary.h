@@ -3,6 +3,7 @@
 #include "mList.h"
 #include "mDynArray.h"
 #include "mBlock.h"
+#include "mThreadPool.h"
 
 #include "mUtils.h"
 #include "mCore.h"
@@ -11,7 +12,8 @@
 namespace mContainers {
 
     // Key and Value type must be default constructable for linked list head
-    template<typename Key, typename Val, uint64_t MaxLoad = 1>
+    // The allocator is shared by the bucket array, the entry links and the entry nodes.
+    template<typename Key, typename Val, uint64_t MaxLoad = 1, typename Allocator = Memory>
     class mDictionary
     {
     private:
@@ -20,12 +22,14 @@ namespace mContainers {
             const Key key;
             Val value;
 
-            KeyValPair() : key(), value() {}
+            uint64_t link; // Position in mLinkData
+
+            KeyValPair() : key(), value(), link(0) {}
             KeyValPair(const Key& _key, const Val& _val)
-                : key(_key), value(_val) {}
+                : key(_key), value(_val), link(0) {}
             template<typename... Args>
             KeyValPair(const Key& key, Args&&... valArgs)
-                : key(key), value(std::forward<Args>(valArgs)...) {}
+                : key(key), value(std::forward<Args>(valArgs)...), link(0) {}
             KeyValPair(const KeyValPair&) = default;
             KeyValPair(KeyValPair&&) = default;
 
@@ -40,41 +44,106 @@ namespace mContainers {
         };
 
     private:
-        using Bucket = mList<KeyValPair>;
+        using Bucket = mList<KeyValPair, Allocator>;
+
+        // Only the default allocator is assumed to be safe to call from the rehash tasks
+        static constexpr bool ParallelAllocator = std::is_same_v<Allocator, Memory>;
 
     private:
-        mDynArray<Bucket> mBuckets;
-        mDynArray<KeyValPair*> mLinkData;
+        mDynArray<Bucket, Allocator> mBuckets;
+        mDynArray<KeyValPair*, Allocator> mLinkData;
         uint64_t mSize;
         uint64_t mBucketCount;
         uint64_t mMaxLoad;
 
     public:
-        mDictionary()
-            : mBuckets(DEFAULT_BUCKETS), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+        mDictionary(const Allocator& allocator = Allocator())
+            : mBuckets(DEFAULT_BUCKETS, Bucket(allocator), allocator), mLinkData(allocator), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
 
-    public: // Access Operators
-        Val& operator[](const Key& key)
+        // Entries are re-added in insertion order, so the links point at the copy's own nodes
+        mDictionary(const mDictionary& other)
+            : mBuckets(other.mBucketCount, Bucket(other.allocator()), other.allocator()), mLinkData(other.allocator()),
+            mSize(0), mBucketCount(other.mBucketCount), mMaxLoad(other.mMaxLoad)
         {
-            Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
+            mLinkData.reserve(other.mSize);
+            for (const KeyValPair* kv : other.mLinkData)
+            {
+                KeyValPair& copy = mBuckets[Hash(kv->key)].emplace_front(kv->key, kv->value);
+                copy.link = kv->link;
+                mLinkData.emplace_back(&copy);
+            }
+            mSize = other.mSize;
+        }
 
-            if (bucket.size() == 0) return Add(key);
-            auto it = bucket.find(key);
-            if (it != bucket.end()) return (*it).value;
+        mDictionary(mDictionary&& other)
+            : mDictionary(other.allocator())
+        {
+            swap(other);
+        }
+
+        mDictionary& operator=(const mDictionary& other)
+        {
+            if (this == &other) return *this;
+
+            mDictionary copy(other);
+            swap(copy);
+            return *this;
+        }
+        mDictionary& operator=(mDictionary&& other)
+        {
+            swap(other);
+            return *this;
+        }
 
-            return Add(key);
+        void swap(mDictionary& other)
+        {
+            mBuckets.swap(other.mBuckets);
+            mLinkData.swap(other.mLinkData);
+            std::swap(mSize, other.mSize);
+            std::swap(mBucketCount, other.mBucketCount);
+            std::swap(mMaxLoad, other.mMaxLoad);
+        }
+
+        const Allocator& allocator() const { return mBuckets.allocator(); }
+
+        uint64_t size() const { return mSize; }
+
+    public: // Access Operators
+        Val& operator[](const Key& key)
+        {
+            return *try_emplace(key).first;
         }
 
         const Val& operator[](const Key& key) const
         {
-            const Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
+            const Val* val = find(key);
+            mAssert(val, "Key not in hash table!");
+
+            return *val;
+        }
+
+        // Lookups that never insert
+        Val* find(const Key& key) { return find_hashed(key, hash_key(key)); }
+        const Val* find(const Key& key) const { return find_hashed(key, hash_key(key)); }
+        bool contains(const Key& key) const { return find(key) != nullptr; }
 
-            assert(bucket.size() == 0);
+        // Full hash of a key. Callers probing several tables for the same key can hash it once and pass
+        // the result to the *_hashed methods of each.
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        Val* find_hashed(const Key& key, uint64_t hash)
+        {
+            for (KeyValPair& kv : mBuckets[hash % mBucketCount])
+                if (kv.key == key) return &kv.value;
 
-            const auto it = bucket.find(key);
-            assert(it != bucket.end());
+            return nullptr;
+        }
+        const Val* find_hashed(const Key& key, uint64_t hash) const
+        {
+            for (const KeyValPair& kv : mBuckets[hash % mBucketCount])
+                if (kv.key == key) return &kv.value;
 
-            return (*it).value;
+            return nullptr;
         }
 
     public: // Iterator Methods
@@ -86,47 +155,93 @@ namespace mContainers {
     public: // Element Modifiers
         Val& insert(const Key& key, const Val& val)
         {
-            return Add(key, val);
+            return Add(key, hash_key(key), val);
         }
 
         template<typename... Args>
         Val& emplace(const Key& key, Args&&... args)
         {
-            return Add(key, std::forward<Args>(args)...);
+            return Add(key, hash_key(key), std::forward<Args>(args)...);
+        }
+
+        // insert/emplace with a hash from hash_key()
+        template<typename... Args>
+        Val& insert_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            return Add(key, hash, std::forward<Args>(args)...);
         }
 
-        void erase(const Key& key)
+        // Inserts a value constructed from args unless key is present. Returns the value and whether it was
+        // inserted. The key is hashed and its bucket probed once, growing the table only on insertion.
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            return try_emplace_hashed(key, hash_key(key), std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Val* val = find_hashed(key, hash);
+            if (val) return { val, false };
+
+            return { &Add(key, hash, std::forward<Args>(args)...), true };
+        }
+
+        // Removes key and its value. Returns false if the key was not present.
+        bool erase(const Key& key)
         {
             Bucket& bucket = mBuckets[Hash(key)]; // Cache bucket for the given key
-            if (bucket.size() == 0) return;
 
-            if (auto it = bucket.find(key) != bucket.end())
+            auto prev = bucket.end();
+            for (auto it = bucket.begin(); it != bucket.end(); prev = it++)
             {
-                bucket.erase(it);
+                if ((*it).key != key) continue;
+
+                // The last link moves into the hole, so erasing does not keep the iteration order
+                const uint64_t link = (*it).link;
+                mLinkData.swap_remove(link);
+                if (link < mLinkData.size()) mLinkData[link]->link = link;
+
+                if (prev == bucket.end()) bucket.pop_front();
+                else bucket.erase_after(prev);
                 mSize--;
-                if (auto it = mLinkData.find(&key) != bucket.end()) mLinkData.erase(it);
+
+                return true;
             }
 
+            return false;
+        }
+
+        // Grows the table so count entries fit without further rehashing
+        void reserve(uint64_t count)
+        {
+            if ((count / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(count / mMaxLoad));
+
+            mLinkData.reserve(count);
         }
 
     private: // Underlying Element Modifier Methods
         // This will cause any existing buckets to become invalidated if a rehashing occurs.
-        Val& Add(const Key& key)
+        // The full hash is kept, so a rehash in between does not hash the key again.
+        Val& Add(const Key& key, uint64_t hash)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(mBucketCount * 2));
 
-            KeyValPair& kv = mBuckets[Hash(key)].emplace_front(key);
+            KeyValPair& kv = mBuckets[hash % mBucketCount].emplace_front(key);
+            kv.link = mLinkData.size();
             mLinkData.emplace_back(&kv);
             mSize++;
 
             return kv.value;
         }
 
-        Val& Add(const Key& key, const Val& value)
+        Val& Add(const Key& key, uint64_t hash, const Val& value)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(mBucketCount * 2));
 
-            KeyValPair& kv = mBuckets[Hash(key)].emplace_back(key, value);
+            KeyValPair& kv = mBuckets[hash % mBucketCount].emplace_front(key, value);
+            kv.link = mLinkData.size();
             mLinkData.emplace_back(&kv);
             mSize++;
 
@@ -134,11 +249,12 @@ namespace mContainers {
         }
 
         template<typename... Args>
-        Val& Add(const Key& key, Args&&... args)
+        Val& Add(const Key& key, uint64_t hash, Args&&... args)
         {
-            if ((mSize / mBucketCount) >= mMaxLoad) ReHash();
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(mBucketCount * 2));
 
-            KeyValPair& kv = mBuckets[Hash(key)].emplace_front(key, std::forward<Args>(args)...);
+            KeyValPair& kv = mBuckets[hash % mBucketCount].emplace_front(key, std::forward<Args>(args)...);
+            kv.link = mLinkData.size();
             mLinkData.emplace_back(&kv);
             mSize++;
 
@@ -148,23 +264,30 @@ namespace mContainers {
     private: // Hashing Related Methods
         uint64_t Hash(const Key& key) const
         {
-            return Utils::SuperFastHash(key) % mBucketCount;
+            return hash_key(key) % mBucketCount;
         }
         uint64_t Hash(const Key* key) const
         {
             assert(key);
-            return Utils::SuperFastHash(*key) % mBucketCount;
+            return hash_key(*key) % mBucketCount;
         }
 
-        void ReHash()
+        void ReHash(uint64_t bucketCount)
         {
-            mBucketCount = Utils::NextPrime(mBucketCount * 2);
-            mBlock<Bucket> newBuckets(Memory::Alloc<Bucket>(mBucketCount), mBucketCount, true);
-            mBlock<KeyValPair*> newLinkData(Memory::Alloc<KeyValPair*>(mSize), mSize);
+            if (ParallelAllocator && mSize >= PARALLEL_REHASH_SIZE && mThreadPool::Get().size() > 1)
+            {
+                ParallelReHash(bucketCount);
+                return;
+            }
+
+            mBucketCount = bucketCount;
+            mBlock<Bucket> newBuckets(mBuckets.allocator().template Alloc<Bucket>(mBucketCount), mBucketCount, allocator());
+            mBlock<KeyValPair*> newLinkData(mLinkData.allocator().template Alloc<KeyValPair*>(mSize), mSize);
 
             for (const KeyValPair* kv : mLinkData)
             {
                 KeyValPair& movedPair = newBuckets[Hash(kv->key)].emplace_front(kv->key, kv->value);
+                movedPair.link = kv->link;
                 newLinkData.emplace_back(&movedPair);
             }
             
@@ -173,6 +296,42 @@ namespace mContainers {
 
         }
 
+        // Same result as ReHash, but hashing and bucket insertion are spread over the thread pool.
+        // Entries are partitioned by destination bucket range, so each task owns its buckets outright.
+        void ParallelReHash(uint64_t bucketCount)
+        {
+            mThreadPool& pool = mThreadPool::Get();
+            const uint64_t tasks = pool.size();
+
+            mBucketCount = bucketCount;
+            mBlock<Bucket> newBuckets(mBuckets.allocator().template Alloc<Bucket>(mBucketCount), mBucketCount, allocator());
+            mBlock<KeyValPair*> newLinkData(mLinkData.allocator().template Alloc<KeyValPair*>(mSize), mSize, true);
+
+            mDynArray<uint64_t> bucketOf(mSize);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t i = mSize * task / tasks; i < mSize * (task + 1) / tasks; i++)
+                    bucketOf[i] = Hash(mLinkData[i]->key);
+            });
+
+            mDynArray<uint64_t> order, starts;
+            Parallel::PartitionIndices(mSize, tasks, [&](uint64_t i) { return bucketOf[i] * tasks / mBucketCount; }, order, starts);
+
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t j = starts[task]; j < starts[task + 1]; j++)
+                {
+                    uint64_t i = order[j];
+                    const KeyValPair* kv = mLinkData[i];
+                    newLinkData[i] = &newBuckets[bucketOf[i]].emplace_front(kv->key, kv->value);
+                    newLinkData[i]->link = i;
+                }
+            });
+
+            mBuckets = newBuckets;
+            mLinkData = newLinkData;
+        }
+
     public:
         void printCollisionDist()
         {
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <iterator>
+
 #include "mCore.h"
 #include "mBlock.h"
+#include "mSimd.h"
+
+#if defined(M_PLATFORM_LINUX)
+	#include <sys/mman.h>
+#endif
 
 namespace mContainers {
 
@@ -28,7 +35,7 @@ namespace mContainers {
 		mDynIterator operator++(int)
 		{
 			mDynIterator temp = *this;
-			temp++;
+			++(*this);
 			return temp;
 		}
 
@@ -40,7 +47,7 @@ namespace mContainers {
 		mDynIterator operator--(int)
 		{
 			mDynIterator temp = *this;
-			temp--;
+			--(*this);
 			return temp;
 		}
 
@@ -99,74 +106,182 @@ namespace mContainers {
 		operator TypePtr() { return mPtr; }
 	};
 
-	template<typename T>
-	class mDynArray
+	// Growth policies for mDynArray. Next(capacity, required, elementSize, inPlace) returns the capacity to grow
+	// to, at least required. inPlace is set when the buffer is mmap backed and grows with mremap instead of a copy.
+	namespace Growth {
+
+		struct Double
+		{
+			static uint64_t Next(uint64_t capacity, uint64_t required, uint64_t, bool)
+			{
+				uint64_t next = capacity ? 2 * capacity : 4;
+				return next > required ? next : required;
+			}
+		};
+
+		// The blocks freed while growing add up to more than the next request, so the allocator can reuse them
+		struct OneAndHalf
+		{
+			static uint64_t Next(uint64_t capacity, uint64_t required, uint64_t, bool)
+			{
+				uint64_t next = capacity > 1 ? capacity + capacity / 2 : 4;
+				return next > required ? next : required;
+			}
+		};
+
+		// Grows mmap backed arrays by whole chunks, which mremap adds without copying, so the capacity stays
+		// within a chunk of the size. Arrays that would have to be copied keep doubling.
+		template<uint64_t ChunkBytes = DYNARRAY_MAP_SIZE>
+		struct Paged
+		{
+			static uint64_t Next(uint64_t capacity, uint64_t required, uint64_t elementSize, bool inPlace)
+			{
+				uint64_t bytes = capacity * elementSize;
+				if (!inPlace || bytes < ChunkBytes) return Double::Next(capacity, required, elementSize, inPlace);
+
+				uint64_t next = (bytes / ChunkBytes + 1) * ChunkBytes / elementSize;
+				return next > required ? next : required;
+			}
+		};
+
+	}
+
+	// Nothing is allocated until the first element or reserve
+	template<typename T, typename Allocator = Memory, typename GrowthPolicy = Growth::Double>
+	class mDynArray : private mAllocatorStorage<Allocator>
 	{
 	public:
-		using VecType = mDynArray<T>;
-		using Iterator = mDynIterator<mDynArray<T>>;
+		using VecType = mDynArray<T, Allocator, GrowthPolicy>;
+		using Iterator = mDynIterator<VecType>;
 		using ValType = T;
+		using AllocatorType = Allocator;
+
+	private:
+		using Storage = mAllocatorStorage<Allocator>;
+
+		// Keeps (count, value) calls away from the iterator range overloads
+		template<typename It>
+		using IteratorCheck = decltype(*std::declval<It&>(), ++std::declval<It&>());
 
 	protected:
+		static constexpr bool Relocatable = mIsTriviallyRelocatable<T>::value;
+
 		T* mData;
 
 		uint64_t mSize;
 		uint64_t mCapacity;
+		bool mMapped;	// Buffer comes from mmap rather than the allocator
 
 	public:
 		mDynArray()
-			: mData(nullptr), mSize(0), mCapacity(0)
-		{ 
-			ReAlloc(5);
-		}
+			: mData(nullptr), mSize(0), mCapacity(0), mMapped(false) {}
+
+		explicit mDynArray(const Allocator& allocator)
+			: Storage(allocator), mData(nullptr), mSize(0), mCapacity(0), mMapped(false) {}
 
-		mDynArray(uint64_t count)
-			: mData(nullptr), mSize(0), mCapacity(0)
+		mDynArray(uint64_t count, const Allocator& allocator = Allocator())
+			: Storage(allocator), mData(nullptr), mSize(0), mCapacity(0), mMapped(false)
 		{
 			ReAllocConstruct(count);
 		}
 
-		mDynArray(uint64_t count, const T& val)
-			: mData(nullptr), mSize(0), mCapacity(0)
+		mDynArray(uint64_t count, const T& val, const Allocator& allocator = Allocator())
+			: Storage(allocator), mData(nullptr), mSize(0), mCapacity(0), mMapped(false)
 		{
 			ReAllocConstruct(count, val);
 		}
 
+		template<typename InputIt, typename = IteratorCheck<InputIt>>
+		mDynArray(InputIt first, InputIt last, const Allocator& allocator = Allocator())
+			: Storage(allocator), mData(nullptr), mSize(0), mCapacity(0), mMapped(false)
+		{
+			assign(first, last);
+		}
+
 	//private: //Only for use by dictionary - must be fully initialised or unitialised, no mix state
-		mDynArray(T* dataBlock, uint64_t length, bool initialised = false)
+		// dataBlock must come from the allocator, the array takes ownership of it
+		mDynArray(T* dataBlock, uint64_t length, bool initialised = false, const Allocator& allocator = Allocator())
+			: Storage(allocator)
 		{
 			mCapacity = length;
-			if (initialised) mSize = length;
+			mSize = initialised ? length : 0;
 			mData = dataBlock;
+			mMapped = false;
 		}
 
 	public:
+		mDynArray(const mDynArray& other)
+			: Storage(other.allocator()), mData(nullptr), mSize(0), mCapacity(0), mMapped(false)
+		{
+			ReAlloc(other.mCapacity);
+			for (uint64_t i = 0; i < other.mSize; i++)
+				Memory::Emplace<T>(&mData[i], other.mData[i]);
+
+			mSize = other.mSize;
+		}
+
+		mDynArray(mDynArray&& other)
+			: mDynArray(other.allocator())
+		{
+			swap(other);
+		}
+
 		~mDynArray()
 		{
 			clear();
-			::operator delete(mData, mCapacity * sizeof(T));
+			Release(mData, mCapacity, mMapped);
+		}
+
+		VecType& operator=(const mDynArray& other)
+		{
+			if (this == &other) return *this;
+
+			mDynArray copy(other);
+			swap(copy);
+			return *this;
 		}
+		VecType& operator=(mDynArray&& other)
+		{
+			swap(other);
+			return *this;
+		}
+
+		void swap(mDynArray& other)
+		{
+			std::swap(mData, other.mData);
+			std::swap(mSize, other.mSize);
+			std::swap(mCapacity, other.mCapacity);
+			std::swap(mMapped, other.mMapped);
+			std::swap(allocator(), other.allocator());
+		}
+
+		using Storage::allocator;
 
 		void push_back(const T& value)
 		{
 			if (mSize >= mCapacity)
-				ReAlloc(2 * mCapacity);
+			{
+				T copy(value); // value may live in the buffer being replaced
+				Grow();
+				Memory::Emplace<T>(&mData[mSize++], std::move(copy));
+				return;
+			}
 
-			mData[mSize++] = value;
+			Memory::Emplace<T>(&mData[mSize++], value);
 		}
 		void push_back(T&& value)
 		{
 			if (mSize >= mCapacity)
-				ReAlloc(2 * mCapacity);
+				Grow();
 
-			mData[mSize++] = std::move(value);
+			Memory::Emplace<T>(&mData[mSize++], std::move(value));
 		}
 
 		template<typename... Args>
 		T& emplace_back(Args&&... args)
 		{
 			if (mSize >= mCapacity)
-				ReAlloc(2 * mCapacity);
+				Grow();
 
 			Memory::Emplace<T>(&mData[mSize], std::forward<Args>(args)...);
 			return mData[mSize++];
@@ -176,7 +291,99 @@ namespace mContainers {
 		{
 			assert(mSize > 0);
 
-			mData[mSize--].~T();
+			mData[--mSize].~T();
+		}
+
+		// Bulk modifiers reserve once for the whole range. Trivially copyable elements from pointers or
+		// mDynArray iterators are copied with memcpy. The range may come from this array.
+		template<typename InputIt, typename = IteratorCheck<InputIt>>
+		void append(InputIt first, InputIt last)
+		{
+			uint64_t count = Distance(first, last, 0);
+			if (count == 0) return;
+			if (Aliases(first, count))
+			{
+				mDynArray copy(first, last, allocator());
+				append(copy.begin(), copy.end());
+				return;
+			}
+
+			Fit(mSize + count);
+			CopyConstruct(mData + mSize, first, count);
+			mSize += count;
+		}
+
+		void append_n(uint64_t count, const T& value)
+		{
+			if (count == 0) return;
+
+			T fill(value); // value may live in the buffer being replaced
+			Fit(mSize + count);
+			for (uint64_t i = 0; i < count; i++)
+				Memory::Emplace<T>(&mData[mSize + i], fill);
+			mSize += count;
+		}
+
+		// Inserts the range before pos and returns an iterator to its first element
+		template<typename InputIt, typename = IteratorCheck<InputIt>>
+		Iterator insert(const Iterator& pos, InputIt first, InputIt last)
+		{
+			uint64_t index = Iterator(pos) - begin();
+			mAssert(index <= mSize, "Insert position out of range!");
+
+			uint64_t count = Distance(first, last, 0);
+			if (count == 0) return Iterator(mData + index);
+			if (Aliases(first, count))
+			{
+				mDynArray copy(first, last, allocator());
+				return insert(Iterator(mData + index), copy.begin(), copy.end());
+			}
+
+			Fit(mSize + count);
+			if constexpr (Relocatable)
+			{
+				if (index < mSize) memmove((void*)(mData + index + count), (const void*)(mData + index), (mSize - index) * sizeof(T));
+			}
+			else
+			{
+				// Open the gap from the back, leaving it uninitialised
+				for (uint64_t i = mSize; i > index; i--)
+				{
+					Memory::Emplace<T>(&mData[i - 1 + count], std::move(mData[i - 1]));
+					mData[i - 1].~T();
+				}
+			}
+
+			CopyConstruct(mData + index, first, count);
+			mSize += count;
+
+			return Iterator(mData + index);
+		}
+
+		// Replaces the contents with the range, growing to exactly its size if needed
+		template<typename InputIt, typename = IteratorCheck<InputIt>>
+		void assign(InputIt first, InputIt last)
+		{
+			uint64_t count = Distance(first, last, 0);
+			if (Aliases(first, count))
+			{
+				mDynArray copy(first, last, allocator());
+				swap(copy);
+				return;
+			}
+
+			clear();
+			if (count > mCapacity) ReAlloc(count);
+			CopyConstruct(mData, first, count);
+			mSize = count;
+		}
+
+		void assign(uint64_t count, const T& value)
+		{
+			T fill(value); // value may be one of the elements being cleared
+			clear();
+			if (count > mCapacity) ReAlloc(count);
+			append_n(count, fill);
 		}
 
 		void clear()
@@ -187,10 +394,9 @@ namespace mContainers {
 			mSize = 0;
 		}
 		
-	protected:
 		T* data() { return mData; }
+		const T* data() const { return mData; }
 
-	public:
 		T& operator[](uint64_t index)
 		{
 			mAssert(index < mSize, "Index out of range!");
@@ -207,11 +413,12 @@ namespace mContainers {
 		VecType& operator=(const mBlock<T>& other)
 		{
 			clear();
-			::operator delete(mData, mCapacity * sizeof(T));
+			Release(mData, mCapacity, mMapped);
 
 			mData = other.mData;
 			mSize = other.mSize;
 			mCapacity = other.mCapacity;
+			mMapped = false;
 
 			return *this;
 		}
@@ -244,39 +451,82 @@ namespace mContainers {
 			return it;
 		}
 
+		// Vectorised for arithmetic, enum and pointer elements, see mSimd.h
 		Iterator find(const T& value)
 		{
-			return find(begin(), end(), value);
+			return Iterator(mData + Simd::Find(mData, mSize, value));
 		}
 
-		void erase(Iterator& it)
+		uint64_t count(const T& value) const { return Simd::Count(mData, mSize, value); }
+		bool contains(const T& value) const { return Simd::Find(mData, mSize, value) != mSize; }
+
+		// First element equal to any of values
+		Iterator find_if_equal_any(const T* values, uint64_t valueCount)
 		{
-			// Destroy object and go to next in mDynArray
-			(*it++).~T();
+			return Iterator(mData + Simd::FindAny(mData, mSize, values, valueCount));
+		}
+		Iterator find_if_equal_any(std::initializer_list<T> values)
+		{
+			return find_if_equal_any(values.begin(), values.size());
+		}
 
-			// Loop from next element after the one to erase to end and overwrite the previous iterator
-			for (it; it != end(); it++)
-				*(it - 1) = std::move(*it);
+		// Smallest and largest element by operator<, the array must not be empty
+		T min() const { return Simd::Min(mData, mSize); }
+		T max() const { return Simd::Max(mData, mSize); }
 
-			mSize--;
+		// Keeps the order of the remaining elements, shifting the later ones down. Use swap_remove when the
+		// order does not matter, or erase_if to remove many elements in one pass.
+		void erase(const Iterator& it)
+		{
+			erase(it, it + 1);
 		}
 
+		// Removes [rangeBegin, rangeEnd)
 		void erase(const Iterator& rangeBegin, const Iterator& rangeEnd)
 		{
-			// Quality of life addition so using end iterator will use the last element
-			// (end() points to first pointer after the last element)
-			Iterator endCheck = rangeEnd;
-			if (rangeEnd == end())
-				endCheck--;
+			uint64_t first = Iterator(rangeBegin) - begin();
+			uint64_t last = Iterator(rangeEnd) - begin();
+			mAssert(first <= last && last <= mSize, "Erase range out of bounds!");
+			if (first == last) return;
+
+			uint64_t to = first;
+			for (uint64_t from = last; from < mSize; from++, to++)
+				mData[to] = std::move(mData[from]);
+			for (uint64_t i = to; i < mSize; i++)
+				mData[i].~T();
+
+			mSize = to;
+		}
+
+		// O(1) removal that moves the last element into the hole
+		void swap_remove(uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			if (index != mSize - 1) mData[index] = std::move(mData[mSize - 1]);
+			mData[--mSize].~T();
+		}
+
+		// Removes every element matching pred in one stable pass, returns how many were removed. Kept elements
+		// are moved down over the removed ones, so destructors only run on the leftover tail.
+		template<typename Pred>
+		uint64_t erase_if(Pred&& pred)
+		{
+			uint64_t to = 0;
+			for (uint64_t from = 0; from < mSize; from++)
+			{
+				if (pred(mData[from])) continue;
 
-			Iterator to = rangeBegin;
-			for (Iterator from = endCheck + 1; from != end(); from++, to++)
-				*to = std::move(*from);
+				if (to != from) mData[to] = std::move(mData[from]);
+				to++;
+			}
 
-			for (; to != end(); to++)
-				(*to).~T();
+			uint64_t removed = mSize - to;
+			for (uint64_t i = to; i < mSize; i++)
+				mData[i].~T();
+			mSize = to;
 
-			mSize -= (rangeEnd - rangeBegin);
+			return removed;
 		}
 
 		Iterator begin()
@@ -298,63 +548,185 @@ namespace mContainers {
 		}
 
 	protected:
+		// Moves the elements to a buffer of newCapacity, dropping any that no longer fit. Relocatable types
+		// are moved with memcpy, and mapped buffers grow or shrink in place with mremap when they stay large.
 		void ReAlloc(uint64_t newCapacity)
 		{
-			T* newBlock = Memory::Alloc<T>(newCapacity);
-
 			uint64_t newSize = mSize;
 			if (newCapacity < mSize) newSize = newCapacity;
-			for (uint64_t i = 0; i < newSize; i++)
-				Memory::Emplace<T>(&newBlock[i], std::move(mData[i])); // Move construct new data from current data
-
-			if (mData) Memory::Free<T>(mData, mCapacity);
+			for (uint64_t i = newSize; i < mSize; i++)
+				mData[i].~T();
+			mSize = newSize;
+
+			if (Remap(newCapacity)) return;
+
+			bool mapped = false;
+			T* newBlock = Acquire(newCapacity, mapped);
+			if constexpr (Relocatable)
+			{
+				if (mSize > 0) memcpy((void*)newBlock, (const void*)mData, mSize * sizeof(T));
+			}
+			else
+			{
+				for (uint64_t i = 0; i < mSize; i++)
+				{
+					Memory::Emplace<T>(&newBlock[i], std::move(mData[i])); // Move construct new data from current data
+					mData[i].~T(); // Call destructor for moved data
+				}
+			}
+
+			Release(mData, mCapacity, mMapped);
 			mData = newBlock;
 			mCapacity = newCapacity;
+			mMapped = mapped;
 		}
 
 		void ReAllocConstruct(uint64_t newCapacity)
 		{
-			T* newBlock = Memory::Alloc<T>(newCapacity);
-
-			uint64_t oldSize = mSize;
-			if (newCapacity < mSize) mSize = newCapacity;
-			for (uint64_t i = 0; i < mSize; i++)
-				Memory::Emplace<T>(&newBlock[i], std::move(mData[i])); // Move construct new data from current data
+			ReAlloc(newCapacity);
 
 			for (uint64_t i = mSize; i < newCapacity; i++)
-				Memory::Emplace<T>(&newBlock[i]); // Initialise new data if growing
+				Memory::Emplace<T>(&mData[i]); // Initialise new data if growing
+			mSize = newCapacity;
+		}
 
-			for (uint64_t i = 0; i < oldSize; i++)
-				mData[i].~T(); // Call destructor for moved data
+		void ReAllocConstruct(uint64_t newCapacity, const T& val)
+		{
+			T value(val); // val may live in the buffer being replaced
+			ReAlloc(newCapacity);
 
-			if (mData) 
-				Memory::Free<T>(mData, mCapacity);
-			mData = newBlock;
-			mCapacity = newCapacity;
+			for (uint64_t i = mSize; i < newCapacity; i++)
+				Memory::Emplace<T>(&mData[i], value); // Initialise new data if growing
 			mSize = newCapacity;
 		}
 
-		void ReAllocConstruct(uint64_t newCapacity, const T& val)
+	private:
+		void Grow() { ReAlloc(GrowthPolicy::Next(mCapacity, mSize + 1, sizeof(T), mMapped)); }
+
+		// Grows once so that required elements fit
+		void Fit(uint64_t required)
 		{
-			T* newBlock = Memory::Alloc<T>(newCapacity);
+			if (required > mCapacity) ReAlloc(GrowthPolicy::Next(mCapacity, required, sizeof(T), mMapped));
+		}
 
-			uint64_t newSize = mSize;
-			if (newCapacity < mSize) newSize = newCapacity;
-			for (uint64_t i = 0; i < newSize; i++)
-				Memory::Emplace<T>(&newBlock[i], std::move(mData[i])); // Move construct new data from current data
+		// Pointers and mDynArray iterators address their elements directly
+		template<typename It>
+		static constexpr bool Contiguous = std::is_pointer_v<It> || std::is_same_v<It, Iterator>;
 
-			for (uint64_t i = mSize; i < newSize; i++)
-				Memory::Emplace<T>(&newBlock[i]); // Initialise new data if growing
+		// Standard iterators go through std::distance, our own are subtracted when contiguous and walked otherwise
+		template<typename It>
+		static auto Distance(It first, It last, int) -> decltype(typename std::iterator_traits<It>::iterator_category(), uint64_t())
+		{
+			return (uint64_t)std::distance(first, last);
+		}
+		template<typename It>
+		static uint64_t Distance(It first, It last, long)
+		{
+			if constexpr (Contiguous<It>) return last - first;
 
-			for (uint64_t i = 0; i < mSize; i++)
-				mData[i].~T(); // Call destructor for moved data
+			uint64_t count = 0;
+			for (; first != last; ++first)
+				count++;
 
-			if (mData)
-				Memory::Free<T>(mData, mCapacity);
-			mData = newBlock;
+			return count;
+		}
+
+		// Whether a range starting at first lies in this array's buffer, which growing would free
+		template<typename It>
+		bool Aliases(It first, uint64_t count) const
+		{
+			if constexpr (Contiguous<It>)
+			{
+				const T* source = &*first;
+				return count > 0 && source >= mData && source < mData + mSize;
+			}
+			else
+			{
+				M_NOT_USED(first);
+				M_NOT_USED(count);
+				return false;
+			}
+		}
+
+		// Copy constructs count elements at dst, which must be uninitialised
+		template<typename It>
+		static void CopyConstruct(T* dst, It first, uint64_t count)
+		{
+			if constexpr (Contiguous<It> && std::is_trivially_copyable_v<T>)
+			{
+				if (count > 0) memcpy((void*)dst, (const void*)&*first, count * sizeof(T));
+			}
+			else
+			{
+				for (uint64_t i = 0; i < count; i++, ++first)
+					Memory::Emplace<T>(&dst[i], *first);
+			}
+		}
+
+		// Only arrays on the default allocator are mapped, other allocators see every allocation
+		static bool UseMap(uint64_t capacity)
+		{
+#if defined(M_PLATFORM_LINUX)
+			return Relocatable && std::is_same_v<Allocator, Memory> && capacity * sizeof(T) >= DYNARRAY_MAP_SIZE;
+#else
+			M_NOT_USED(capacity);
+			return false;
+#endif
+		}
+
+		T* Acquire(uint64_t capacity, bool& mapped)
+		{
+#if defined(M_PLATFORM_LINUX)
+			if (UseMap(capacity))
+			{
+				void* block = ::mmap(nullptr, capacity * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (block != MAP_FAILED)
+				{
+					mapped = true;
+					return static_cast<T*>(block);
+				}
+			}
+#endif
+			mapped = false;
+			return this->template Allocate<T>(capacity);
+		}
+
+		void Release(T* data, uint64_t capacity, bool mapped)
+		{
+			if (!data) return;
+
+#if defined(M_PLATFORM_LINUX)
+			if (mapped)
+			{
+				::munmap(data, capacity * sizeof(T));
+				return;
+			}
+#endif
+			M_NOT_USED(mapped);
+			this->template Deallocate<T>(data, capacity);
+		}
+
+		// Resizes a mapped buffer without copying, the kernel moves page table entries instead of the data
+		bool Remap(uint64_t newCapacity)
+		{
+#if defined(M_PLATFORM_LINUX)
+			if (!mMapped || !UseMap(newCapacity)) return false;
+
+			void* block = ::mremap(mData, mCapacity * sizeof(T), newCapacity * sizeof(T), MREMAP_MAYMOVE);
+			if (block == MAP_FAILED) return false;
+
+			mData = static_cast<T*>(block);
 			mCapacity = newCapacity;
-			mSize = newCapacity;
+			return true;
+#else
+			M_NOT_USED(newCapacity);
+			return false;
+#endif
 		}
 	};
 
+	// Only holds a pointer to its elements, so moving it to a new address needs no fixups beyond its allocator's
+	template<typename T, typename Allocator, typename GrowthPolicy>
+	struct mIsTriviallyRelocatable<mDynArray<T, Allocator, GrowthPolicy>> : mIsTriviallyRelocatable<Allocator> {};
+
 }
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+	// Sorted associative array for read-mostly lookups. Keys and values are kept in separate sorted arrays
+	// so searches only touch key memory. Inserts are staged and merged in a single pass by commit().
+	// Once frozen, keys are additionally laid out in Eytzinger (BFS) order for a branchless, prefetching search.
+	// Key must be default constructable and comparable with operator<. Every array shares the allocator.
+	template<typename Key, typename Val, typename Allocator = Memory>
+	class mFlatMap
+	{
+	private:
+		struct Entry
+		{
+			Key key;
+			Val value;
+
+			Entry() : key(), value() {}
+			Entry(const Key& _key, const Val& _val)
+				: key(_key), value(_val) {}
+			template<typename... Args>
+			Entry(const Key& _key, Args&&... valArgs)
+				: key(_key), value(std::forward<Args>(valArgs)...) {}
+		};
+
+		// Number of Eytzinger nodes that share a cache line, used as the prefetch stride
+		static constexpr uint64_t sBlockSize = sizeof(Key) < 64 ? 64 / sizeof(Key) : 1;
+
+	private:
+		mDynArray<Key, Allocator> mKeys;
+		mDynArray<Val, Allocator> mValues;
+		mDynArray<Entry, Allocator> mPending;
+
+		mDynArray<Key, Allocator> mEytzinger;			// 1-based BFS layout of mKeys, slot 0 unused
+		mDynArray<uint64_t, Allocator> mEytzingerIndex;	// Eytzinger slot -> sorted index
+		bool mFrozen;
+
+	public:
+		mFlatMap(const Allocator& allocator = Allocator())
+			: mKeys(allocator), mValues(allocator), mPending(allocator), mEytzinger(allocator), mEytzingerIndex(allocator),
+			mFrozen(false) {}
+
+		const Allocator& allocator() const { return mKeys.allocator(); }
+
+	public: // Access Operators
+		Val* find(const Key& key)
+		{
+			uint64_t index = lower_bound(key);
+			if (index == mKeys.size() || key < mKeys[index]) return nullptr;
+
+			return &mValues[index];
+		}
+		const Val* find(const Key& key) const
+		{
+			uint64_t index = lower_bound(key);
+			if (index == mKeys.size() || key < mKeys[index]) return nullptr;
+
+			return &mValues[index];
+		}
+
+		bool contains(const Key& key) const { return find(key) != nullptr; }
+
+		const Val& operator[](const Key& key) const
+		{
+			const Val* val = find(key);
+			mAssert(val, "Key not in map!");
+
+			return *val;
+		}
+
+		// Index of the first committed key not less than key, or size() if there is none.
+		uint64_t lower_bound(const Key& key) const
+		{
+			mAssert(mPending.size() == 0, "Commit pending inserts before searching!");
+
+			return mFrozen ? SearchEytzinger(key) : SearchSorted(key);
+		}
+
+	public: // Element Modifiers
+		// Staged until the next commit(). The last value inserted for a key wins.
+		void insert(const Key& key, const Val& val)
+		{
+			mPending.emplace_back(key, val);
+		}
+
+		template<typename... Args>
+		void emplace(const Key& key, Args&&... args)
+		{
+			mPending.emplace_back(key, std::forward<Args>(args)...);
+		}
+
+		// Sorts the staged batch and merges it with the committed keys in one pass.
+		void commit()
+		{
+			if (mPending.size() == 0) return;
+
+			Entry* first = mPending.data();
+			Entry* last = first + mPending.size();
+			std::stable_sort(first, last, [](const Entry& lhs, const Entry& rhs) { return lhs.key < rhs.key; });
+
+			mDynArray<Key, Allocator> keys(allocator());
+			mDynArray<Val, Allocator> values(allocator());
+			keys.reserve(mKeys.size() + mPending.size());
+			values.reserve(mKeys.size() + mPending.size());
+
+			uint64_t i = 0;
+			Entry* next = first;
+			while (i < mKeys.size() || next != last)
+			{
+				if (next == last || (i < mKeys.size() && mKeys[i] < next->key))
+				{
+					keys.emplace_back(std::move(mKeys[i]));
+					values.emplace_back(std::move(mValues[i]));
+					i++;
+					continue;
+				}
+
+				// Skip to the most recent insert of this key, replacing any committed value
+				Entry* run = next;
+				while (run + 1 != last && !(next->key < (run + 1)->key))
+					run++;
+				if (i < mKeys.size() && !(next->key < mKeys[i]))
+					i++;
+
+				keys.emplace_back(std::move(run->key));
+				values.emplace_back(std::move(run->value));
+				next = run + 1;
+			}
+
+			mKeys.swap(keys);
+			mValues.swap(values);
+			mPending.clear();
+
+			if (mFrozen) BuildEytzinger();
+		}
+
+		// Re-lays the committed keys in Eytzinger order. Lookups use the new layout until thaw().
+		void freeze()
+		{
+			commit();
+			BuildEytzinger();
+			mFrozen = true;
+		}
+
+		void thaw()
+		{
+			mEytzinger.clear();
+			mEytzingerIndex.clear();
+			mFrozen = false;
+		}
+
+		void clear()
+		{
+			thaw();
+			mKeys.clear();
+			mValues.clear();
+			mPending.clear();
+		}
+
+	public:
+		uint64_t size() const { return mKeys.size(); }
+		uint64_t pending() const { return mPending.size(); }
+		bool frozen() const { return mFrozen; }
+
+		const mDynArray<Key, Allocator>& keys() const { return mKeys; }
+		const mDynArray<Val, Allocator>& values() const { return mValues; }
+
+	private: // Search Methods
+		uint64_t SearchSorted(const Key& key) const
+		{
+			uint64_t length = mKeys.size();
+			if (length == 0) return 0;
+
+			const Key* first = mKeys.data();
+			const Key* base = first;
+			while (length > 1)
+			{
+				uint64_t half = length / 2;
+				base += (base[half] < key) ? half : 0; // Compiles to a conditional move
+				length -= half;
+			}
+
+			return (base - first) + (*base < key);
+		}
+
+		uint64_t SearchEytzinger(const Key& key) const
+		{
+			const uint64_t count = mKeys.size();
+			const Key* eytzinger = mEytzinger.data();
+
+			uint64_t k = 1;
+			while (k <= count)
+			{
+				M_PREFETCH(eytzinger + k * sBlockSize);
+				k = 2 * k + (eytzinger[k] < key);
+			}
+
+			// Undo the trailing right turns to recover the last left turn, which is the lower bound
+			k >>= Utils::CountTrailingZeros(~k) + 1;
+
+			return k == 0 ? count : mEytzingerIndex[k];
+		}
+
+		void BuildEytzinger()
+		{
+			mEytzinger.resize(mKeys.size() + 1);
+			mEytzingerIndex.resize(mKeys.size() + 1);
+			FillEytzinger(0, 1);
+		}
+
+		// In-order walk of the implicit tree, so slots are filled with keys in sorted order
+		uint64_t FillEytzinger(uint64_t i, uint64_t k)
+		{
+			if (k > mKeys.size()) return i;
+
+			i = FillEytzinger(i, 2 * k);
+			mEytzinger[k] = mKeys[i];
+			mEytzingerIndex[k] = i;
+
+			return FillEytzinger(i + 1, 2 * k + 1);
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,686 @@
+#pragma once
+
+#include "mCore.h"
+#include "mList.h"
+#include "mDynArray.h"
+#include "mThreadPool.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+    // Set counterparts of the dictionaries. Each exposes insert/contains/erase, the *_hashed variants taking a
+    // hash from hash_key(), forEachInRange(first, last, fn) over its slots and insert_batch_hashed() so
+    // SetUnion/SetIntersection/SetDifference can split both the scan and the build of the result. mHashSet
+    // and mDenseHashSet store the full hash, so set operations pass it along without hashing keys again.
+    // mFlatHashSet only keeps a fingerprint and rehashes every key it visits. Results take the allocator of lhs.
+
+    namespace Utils {
+
+        // A key with its hash from hash_key(), the element of the sets' batch inserts
+        template<typename Key>
+        struct HashedKey
+        {
+            Key key;
+            uint64_t hash;
+
+            HashedKey() : key(), hash(0) {}
+            HashedKey(const Key& _key, uint64_t _hash)
+                : key(_key), hash(_hash) {}
+        };
+
+    }
+
+    // Chained buckets, as in mDictionary. Key type must be default constructable.
+    template<typename Key, uint64_t MaxLoad = 1, typename Allocator = Memory>
+    class mHashSet
+    {
+    private:
+        struct Entry
+        {
+            uint64_t hash;
+            Key key;
+
+            Entry() : hash(0), key() {}
+            Entry(uint64_t _hash, const Key& _key)
+                : hash(_hash), key(_key) {}
+        };
+
+        using Bucket = mList<Entry, Allocator>;
+
+        // Only the default allocator is assumed to be safe to call from the batch insert tasks
+        static constexpr bool ParallelAllocator = std::is_same_v<Allocator, Memory>;
+
+    public:
+        using KeyType = Key;
+
+    private:
+        mDynArray<Bucket, Allocator> mBuckets;
+        uint64_t mSize;
+        uint64_t mBucketCount;
+        uint64_t mMaxLoad;
+
+    public:
+        mHashSet(const Allocator& allocator = Allocator())
+            : mBuckets(DEFAULT_BUCKETS, Bucket(allocator), allocator), mSize(0), mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+
+        const Allocator& allocator() const { return mBuckets.allocator(); }
+
+    public: // Access Operators
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        bool contains(const Key& key) const { return contains_hashed(key, hash_key(key)); }
+        bool contains_hashed(const Key& key, uint64_t hash) const
+        {
+            for (const Entry& entry : mBuckets[hash % mBucketCount])
+                if (entry.hash == hash && entry.key == key) return true;
+
+            return false;
+        }
+
+    public: // Element Modifiers
+        // Returns false if the key was already present
+        bool insert(const Key& key) { return insert_hashed(key, hash_key(key)); }
+        bool insert_hashed(const Key& key, uint64_t hash)
+        {
+            if (contains_hashed(key, hash)) return false;
+
+            if ((mSize / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(mBucketCount * 2));
+
+            mBuckets[hash % mBucketCount].emplace_front(hash, key);
+            mSize++;
+            return true;
+        }
+
+        // Inserts every key of the batch. Large batches are partitioned by bucket range over the thread pool,
+        // each task owning its buckets outright, as in mDictionary::ParallelReHash.
+        void insert_batch_hashed(const mDynArray<Utils::HashedKey<Key>>& batch)
+        {
+            mThreadPool& pool = mThreadPool::Get();
+            reserve(mSize + batch.size());
+            if (!ParallelAllocator || batch.size() < PARALLEL_SET_SIZE || pool.size() == 1)
+            {
+                for (const Utils::HashedKey<Key>& entry : batch)
+                    insert_hashed(entry.key, entry.hash);
+                return;
+            }
+
+            const uint64_t tasks = pool.size();
+            mDynArray<uint64_t> order, starts;
+            Parallel::PartitionIndices(batch.size(), tasks, [&](uint64_t i) { return batch[i].hash % mBucketCount * tasks / mBucketCount; }, order, starts);
+
+            mDynArray<uint64_t> added(tasks, 0);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t j = starts[task]; j < starts[task + 1]; j++)
+                {
+                    const Utils::HashedKey<Key>& entry = batch[order[j]];
+                    if (contains_hashed(entry.key, entry.hash)) continue;
+
+                    mBuckets[entry.hash % mBucketCount].emplace_front(entry.hash, entry.key);
+                    added[task]++;
+                }
+            });
+
+            for (uint64_t task = 0; task < tasks; task++)
+                mSize += added[task];
+        }
+
+        bool erase(const Key& key)
+        {
+            uint64_t hash = hash_key(key);
+            Bucket& bucket = mBuckets[hash % mBucketCount];
+
+            auto previous = bucket.end();
+            for (auto it = bucket.begin(); it != bucket.end(); previous = it++)
+            {
+                if ((*it).hash != hash || !((*it).key == key)) continue;
+
+                if (previous == bucket.end())
+                    bucket.pop_front();
+                else
+                    bucket.erase_after(previous);
+
+                mSize--;
+                return true;
+            }
+
+            return false;
+        }
+
+        void reserve(uint64_t count)
+        {
+            if ((count / mBucketCount) < mMaxLoad) return;
+
+            ReHash(Utils::NextPrime(count / mMaxLoad));
+        }
+
+    public: // Iterator Methods
+        uint64_t slotCount() const { return mBucketCount; }
+
+        // Calls fn(key, hash) for every key in buckets [first, last)
+        template<typename Fn>
+        void forEachInRange(uint64_t first, uint64_t last, Fn&& fn) const
+        {
+            for (uint64_t i = first; i < last; i++)
+                for (const Entry& entry : mBuckets[i])
+                    fn(entry.key, entry.hash);
+        }
+
+        uint64_t size() const { return mSize; }
+
+    private: // Hashing Related Methods
+        void ReHash(uint64_t bucketCount)
+        {
+            mDynArray<Bucket, Allocator> buckets(bucketCount, Bucket(allocator()), allocator());
+            for (uint64_t i = 0; i < mBucketCount; i++)
+                for (Entry& entry : mBuckets[i])
+                    buckets[entry.hash % bucketCount].emplace_front(entry.hash, std::move(entry.key));
+
+            mBuckets.swap(buckets);
+            mBucketCount = bucketCount;
+        }
+    };
+
+    // Dense key array with index chains, as in TestDictionary. Keys stay contiguous, erase moves the last key
+    // into the hole. Key type must be default constructable.
+    template<typename Key, uint64_t MaxLoad = 1, typename Allocator = Memory>
+    class mDenseHashSet
+    {
+    private:
+        static constexpr uint64_t NoEntry = (uint64_t)-1;
+
+    public:
+        using KeyType = Key;
+
+    private:
+        mDynArray<Key, Allocator> mKeys;
+        mDynArray<uint64_t, Allocator> mHashes;
+        mDynArray<uint64_t, Allocator> mNext;      // Next entry in the same bucket
+        mDynArray<uint64_t, Allocator> mBuckets;   // First entry in each bucket
+        uint64_t mBucketCount;
+        uint64_t mMaxLoad;
+
+    public:
+        mDenseHashSet(const Allocator& allocator = Allocator())
+            : mKeys(allocator), mHashes(allocator), mNext(allocator), mBuckets(DEFAULT_BUCKETS, NoEntry, allocator),
+            mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+
+        const Allocator& allocator() const { return mKeys.allocator(); }
+
+    public: // Access Operators
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        bool contains(const Key& key) const { return contains_hashed(key, hash_key(key)); }
+        bool contains_hashed(const Key& key, uint64_t hash) const { return Find(key, hash) != NoEntry; }
+
+        const mDynArray<Key, Allocator>& keys() const { return mKeys; }
+
+    public: // Element Modifiers
+        // Returns false if the key was already present
+        bool insert(const Key& key) { return insert_hashed(key, hash_key(key)); }
+        bool insert_hashed(const Key& key, uint64_t hash)
+        {
+            if (Find(key, hash) != NoEntry) return false;
+
+            if ((mKeys.size() / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(mBucketCount * 2));
+
+            uint64_t& head = mBuckets[hash % mBucketCount];
+            mKeys.emplace_back(key);
+            mHashes.emplace_back(hash);
+            mNext.emplace_back(head);
+            head = mKeys.size() - 1;
+            return true;
+        }
+
+        // Inserts every key of the batch. Large batches are partitioned by bucket range over the thread pool.
+        // Each task writes its keys to its own run of the dense arrays and links them into its own buckets,
+        // keys already present leave holes that are closed serially afterwards.
+        void insert_batch_hashed(const mDynArray<Utils::HashedKey<Key>>& batch)
+        {
+            mThreadPool& pool = mThreadPool::Get();
+            reserve(mKeys.size() + batch.size());
+            if (batch.size() < PARALLEL_SET_SIZE || pool.size() == 1)
+            {
+                for (const Utils::HashedKey<Key>& entry : batch)
+                    insert_hashed(entry.key, entry.hash);
+                return;
+            }
+
+            const uint64_t tasks = pool.size();
+            mDynArray<uint64_t> order, starts;
+            Parallel::PartitionIndices(batch.size(), tasks, [&](uint64_t i) { return batch[i].hash % mBucketCount * tasks / mBucketCount; }, order, starts);
+
+            // The jth key in partition order goes to position base + j
+            const uint64_t base = mKeys.size();
+            mKeys.resize(base + batch.size());
+            mHashes.resize(base + batch.size());
+            mNext.resize(base + batch.size());
+
+            mDynArray<uint8_t> present(batch.size(), 0);
+            mDynArray<uint64_t> skipped(tasks, 0);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t j = starts[task]; j < starts[task + 1]; j++)
+                {
+                    const Utils::HashedKey<Key>& entry = batch[order[j]];
+                    const uint64_t index = base + j;
+                    if (Find(entry.key, entry.hash) != NoEntry)
+                    {
+                        present[j] = 1;
+                        skipped[task]++;
+                        continue;
+                    }
+
+                    uint64_t& head = mBuckets[entry.hash % mBucketCount];
+                    mKeys[index] = entry.key;
+                    mHashes[index] = entry.hash;
+                    mNext[index] = head;
+                    head = index;
+                }
+            });
+
+            uint64_t holes = 0;
+            for (uint64_t task = 0; task < tasks; task++)
+                holes += skipped[task];
+            if (holes == 0) return;
+
+            // The chains are rebuilt once the keys are packed
+            uint64_t packed = base;
+            for (uint64_t j = 0; j < batch.size(); j++)
+            {
+                if (present[j]) continue;
+
+                if (packed != base + j)
+                {
+                    mKeys[packed] = std::move(mKeys[base + j]);
+                    mHashes[packed] = mHashes[base + j];
+                }
+                packed++;
+            }
+
+            for (uint64_t i = 0; i < holes; i++)
+            {
+                mKeys.pop_back();
+                mHashes.pop_back();
+                mNext.pop_back();
+            }
+            ReHash(mBucketCount);
+        }
+
+        bool erase(const Key& key)
+        {
+            uint64_t index = Find(key, hash_key(key));
+            if (index == NoEntry) return false;
+
+            Unlink(index);
+            uint64_t last = mKeys.size() - 1;
+            if (index != last)
+            {
+                Unlink(last);
+                mKeys[index] = std::move(mKeys[last]);
+                mHashes[index] = mHashes[last];
+
+                uint64_t& head = mBuckets[mHashes[index] % mBucketCount];
+                mNext[index] = head;
+                head = index;
+            }
+
+            mKeys.pop_back();
+            mHashes.pop_back();
+            mNext.pop_back();
+            return true;
+        }
+
+        void reserve(uint64_t count)
+        {
+            mKeys.reserve(count);
+            mHashes.reserve(count);
+            mNext.reserve(count);
+            if ((count / mBucketCount) >= mMaxLoad) ReHash(Utils::NextPrime(count / mMaxLoad));
+        }
+
+    public: // Iterator Methods
+        auto begin() const { return mKeys.begin(); }
+        auto end() const { return mKeys.end(); }
+
+        uint64_t slotCount() const { return mKeys.size(); }
+
+        // Calls fn(key, hash) for the keys at dense positions [first, last)
+        template<typename Fn>
+        void forEachInRange(uint64_t first, uint64_t last, Fn&& fn) const
+        {
+            for (uint64_t i = first; i < last; i++)
+                fn(mKeys[i], mHashes[i]);
+        }
+
+        uint64_t size() const { return mKeys.size(); }
+
+    private: // Hashing Related Methods
+        uint64_t Find(const Key& key, uint64_t hash) const
+        {
+            uint64_t index = mBuckets[hash % mBucketCount];
+            while (index != NoEntry)
+            {
+                if (mHashes[index] == hash && mKeys[index] == key) return index;
+                index = mNext[index];
+            }
+
+            return NoEntry;
+        }
+
+        void Unlink(uint64_t index)
+        {
+            uint64_t* link = &mBuckets[mHashes[index] % mBucketCount];
+            while (*link != index)
+                link = &mNext[*link];
+
+            *link = mNext[index];
+        }
+
+        void ReHash(uint64_t bucketCount)
+        {
+            mBucketCount = bucketCount;
+            mBuckets.clear();
+            mBuckets.resize(mBucketCount, NoEntry);
+
+            for (uint64_t i = 0; i < mKeys.size(); i++)
+            {
+                uint64_t& head = mBuckets[mHashes[i] % mBucketCount];
+                mNext[i] = head;
+                head = i;
+            }
+        }
+    };
+
+    // Open addressing with linear probing over a power of two table. A control byte per slot holds a 7 bit
+    // fingerprint of the hash, so most mismatching slots are rejected without comparing keys.
+    // Key type must be default constructable.
+    template<typename Key, typename Allocator = Memory>
+    class mFlatHashSet
+    {
+    private:
+        static constexpr uint8_t Empty = 0;
+        static constexpr uint8_t Deleted = 1;
+        static constexpr uint8_t Full = 0x80;   // Set on occupied slots, low 7 bits are the fingerprint
+        static constexpr uint64_t NoSlot = (uint64_t)-1;
+
+    public:
+        using KeyType = Key;
+
+    private:
+        mDynArray<uint8_t, Allocator> mControl;
+        mDynArray<Key, Allocator> mSlots;
+        uint64_t mSize;
+        uint64_t mDeleted;
+        uint64_t mMask;
+
+    public:
+        mFlatHashSet(const Allocator& allocator = Allocator())
+            : mControl(8, Empty, allocator), mSlots(8, allocator), mSize(0), mDeleted(0), mMask(7) {}
+
+        const Allocator& allocator() const { return mControl.allocator(); }
+
+    public: // Access Operators
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        bool contains(const Key& key) const { return contains_hashed(key, hash_key(key)); }
+        bool contains_hashed(const Key& key, uint64_t hash) const { return Find(key, hash) != NoSlot; }
+
+    public: // Element Modifiers
+        // Returns false if the key was already present
+        bool insert(const Key& key) { return insert_hashed(key, hash_key(key)); }
+        bool insert_hashed(const Key& key, uint64_t hash)
+        {
+            if (Find(key, hash) != NoSlot) return false;
+
+            // Keep at most 7/8 of the slots in use, counting tombstones
+            if ((mSize + mDeleted + 1) * 8 > (mMask + 1) * 7)
+                Rebuild((mSize + 1) * 2 > mMask + 1 ? (mMask + 1) * 2 : mMask + 1);
+
+            uint64_t slot = (hash >> 7) & mMask;
+            while (mControl[slot] & Full)
+                slot = (slot + 1) & mMask;
+
+            if (mControl[slot] == Deleted) mDeleted--;
+            mControl[slot] = Fingerprint(hash);
+            mSlots[slot] = key;
+            mSize++;
+            return true;
+        }
+
+        // Inserts every key of the batch. Large batches are partitioned by home slot range over the thread
+        // pool. A task only probes inside its own range, keys whose probe runs past its end are inserted
+        // serially afterwards.
+        void insert_batch_hashed(const mDynArray<Utils::HashedKey<Key>>& batch)
+        {
+            mThreadPool& pool = mThreadPool::Get();
+            if ((mSize + mDeleted + batch.size()) * 8 > (mMask + 1) * 7)
+            {
+                uint64_t capacity = mMask + 1;
+                while ((mSize + batch.size()) * 8 > capacity * 7)
+                    capacity *= 2;
+
+                Rebuild(capacity);
+            }
+
+            if (batch.size() < PARALLEL_SET_SIZE || pool.size() == 1)
+            {
+                for (const Utils::HashedKey<Key>& entry : batch)
+                    insert_hashed(entry.key, entry.hash);
+                return;
+            }
+
+            const uint64_t tasks = pool.size();
+            const uint64_t capacity = mMask + 1;
+            mDynArray<uint64_t> order, starts;
+            Parallel::PartitionIndices(batch.size(), tasks, [&](uint64_t i) { return ((batch[i].hash >> 7) & mMask) * tasks / capacity; }, order, starts);
+
+            mDynArray<uint64_t> added(tasks, 0), reused(tasks, 0);
+            mDynArray<mDynArray<uint64_t>> deferred(tasks);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                // Slots whose home is in this partition, the last one does not wrap around
+                const uint64_t end = ((task + 1) * capacity + tasks - 1) / tasks;
+                for (uint64_t j = starts[task]; j < starts[task + 1]; j++)
+                {
+                    const Utils::HashedKey<Key>& entry = batch[order[j]];
+                    const uint8_t fingerprint = Fingerprint(entry.hash);
+
+                    uint64_t slot = (entry.hash >> 7) & mMask, free = NoSlot;
+                    for (; slot < end && mControl[slot] != Empty; slot++)
+                    {
+                        if (mControl[slot] == fingerprint && mSlots[slot] == entry.key) break;
+                        if (mControl[slot] == Deleted && free == NoSlot) free = slot;
+                    }
+
+                    if (slot == end)
+                    {
+                        deferred[task].emplace_back(order[j]);
+                        continue;
+                    }
+                    if (mControl[slot] != Empty) continue;
+
+                    if (free != NoSlot)
+                    {
+                        slot = free;
+                        reused[task]++;
+                    }
+                    mControl[slot] = fingerprint;
+                    mSlots[slot] = entry.key;
+                    added[task]++;
+                }
+            });
+
+            for (uint64_t task = 0; task < tasks; task++)
+            {
+                mSize += added[task];
+                mDeleted -= reused[task];
+            }
+
+            for (uint64_t task = 0; task < tasks; task++)
+                for (uint64_t i : deferred[task])
+                    insert_hashed(batch[i].key, batch[i].hash);
+        }
+
+        bool erase(const Key& key)
+        {
+            uint64_t slot = Find(key, hash_key(key));
+            if (slot == NoSlot) return false;
+
+            mControl[slot] = Deleted;
+            mSlots[slot] = Key();
+            mSize--;
+            mDeleted++;
+            return true;
+        }
+
+        void reserve(uint64_t count)
+        {
+            uint64_t capacity = mMask + 1;
+            while (count * 8 > capacity * 7)
+                capacity *= 2;
+
+            if (capacity != mMask + 1) Rebuild(capacity);
+        }
+
+    public: // Iterator Methods
+        uint64_t slotCount() const { return mMask + 1; }
+
+        // Calls fn(key, hash) for the occupied slots in [first, last). Only fingerprints are stored,
+        // so the hash is recomputed here.
+        template<typename Fn>
+        void forEachInRange(uint64_t first, uint64_t last, Fn&& fn) const
+        {
+            for (uint64_t i = first; i < last; i++)
+                if (mControl[i] & Full) fn(mSlots[i], hash_key(mSlots[i]));
+        }
+
+        uint64_t size() const { return mSize; }
+
+    private: // Hashing Related Methods
+        static uint8_t Fingerprint(uint64_t hash) { return Full | (uint8_t)(hash & 0x7F); }
+
+        uint64_t Find(const Key& key, uint64_t hash) const
+        {
+            const uint8_t fingerprint = Fingerprint(hash);
+            uint64_t slot = (hash >> 7) & mMask;
+            while (mControl[slot] != Empty)
+            {
+                if (mControl[slot] == fingerprint && mSlots[slot] == key) return slot;
+                slot = (slot + 1) & mMask;
+            }
+
+            return NoSlot;
+        }
+
+        // Reinserts every key into a table of the given power of two capacity, dropping tombstones
+        void Rebuild(uint64_t capacity)
+        {
+            mDynArray<uint8_t, Allocator> control(capacity, Empty, allocator());
+            mDynArray<Key, Allocator> slots(capacity, allocator());
+            const uint64_t mask = capacity - 1;
+
+            for (uint64_t i = 0; i <= mMask; i++)
+            {
+                if (!(mControl[i] & Full)) continue;
+
+                uint64_t hash = hash_key(mSlots[i]);
+                uint64_t slot = (hash >> 7) & mask;
+                while (control[slot] != Empty)
+                    slot = (slot + 1) & mask;
+
+                control[slot] = mControl[i];
+                slots[slot] = std::move(mSlots[i]);
+            }
+
+            mControl.swap(control);
+            mSlots.swap(slots);
+            mMask = mask;
+            mDeleted = 0;
+        }
+    };
+
+    namespace Utils {
+
+        // Appends the keys of source that pass keep(key, hash) to result. For large sets both the scan of
+        // source and the inserts into result are split across the thread pool.
+        template<typename Set, typename Pred>
+        void CollectKeys(const Set& source, Pred&& keep, Set& result)
+        {
+            using Key = typename Set::KeyType;
+            using Found = HashedKey<Key>;
+
+            mThreadPool& pool = mThreadPool::Get();
+            const uint64_t tasks = source.size() >= PARALLEL_SET_SIZE ? pool.size() : 1;
+            const uint64_t slots = source.slotCount();
+
+            mDynArray<mDynArray<Found>> found(tasks);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                mDynArray<Found>& local = found[task];
+                source.forEachInRange(slots * task / tasks, slots * (task + 1) / tasks, [&](const Key& key, uint64_t hash)
+                {
+                    if (keep(key, hash)) local.emplace_back(key, hash);
+                });
+            });
+
+            if (tasks == 1)
+            {
+                result.insert_batch_hashed(found[0]);
+                return;
+            }
+
+            mDynArray<uint64_t> offsets(tasks + 1, 0);
+            for (uint64_t task = 0; task < tasks; task++)
+                offsets[task + 1] = offsets[task] + found[task].size();
+
+            mDynArray<Found> batch(offsets[tasks]);
+            pool.run(tasks, [&](uint64_t task)
+            {
+                for (uint64_t i = 0; i < found[task].size(); i++)
+                    batch[offsets[task] + i] = std::move(found[task][i]);
+            });
+
+            result.insert_batch_hashed(batch);
+        }
+
+    }
+
+    template<typename Set>
+    Set SetUnion(const Set& lhs, const Set& rhs)
+    {
+        using Key = typename Set::KeyType;
+
+        Set result(lhs.allocator());
+        result.reserve(lhs.size() + rhs.size());
+        Utils::CollectKeys(lhs, [](const Key&, uint64_t) { return true; }, result);
+        Utils::CollectKeys(rhs, [&](const Key& key, uint64_t hash) { return !lhs.contains_hashed(key, hash); }, result);
+        return result;
+    }
+
+    template<typename Set>
+    Set SetIntersection(const Set& lhs, const Set& rhs)
+    {
+        using Key = typename Set::KeyType;
+
+        // Probe the larger set with the keys of the smaller one
+        const Set& small = lhs.size() <= rhs.size() ? lhs : rhs;
+        const Set& large = lhs.size() <= rhs.size() ? rhs : lhs;
+
+        Set result(lhs.allocator());
+        Utils::CollectKeys(small, [&](const Key& key, uint64_t hash) { return large.contains_hashed(key, hash); }, result);
+        return result;
+    }
+
+    template<typename Set>
+    Set SetDifference(const Set& lhs, const Set& rhs)
+    {
+        using Key = typename Set::KeyType;
+
+        Set result(lhs.allocator());
+        Utils::CollectKeys(lhs, [&](const Key& key, uint64_t hash) { return !rhs.contains_hashed(key, hash); }, result);
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+    // Dictionary using linear hashing. When the load passes MaxLoad exactly one bucket, the one under the
+    // split pointer, is split in two and the pointer moves on; once every bucket of the current level has been
+    // split the level goes up and the pointer starts over. Bucket heads live in fixed size segments, so adding a
+    // bucket never copies the existing ones and no insert pays for a whole table rehash.
+    // Nodes keep their hash, so a split never hashes a key again.
+    // The allocator is shared by the directory, the segments and the nodes.
+    template<typename Key, typename Val, uint64_t MaxLoad = 1, typename Allocator = Memory>
+    class mLinearDictionary : private mAllocatorStorage<Allocator>
+    {
+    private:
+        using Storage = mAllocatorStorage<Allocator>;
+
+        static constexpr uint64_t InitialBuckets = 8;   // Power of two, bucket index is hash modulo a power of two
+        static constexpr uint64_t SegmentSize = 256;    // Bucket heads per directory segment
+
+        struct Node
+        {
+            Node* next;
+            uint64_t hash;
+            const Key key;
+            Val value;
+
+            template<typename... Args>
+            Node(Node* _next, uint64_t _hash, const Key& _key, Args&&... valArgs)
+                : next(_next), hash(_hash), key(_key), value(std::forward<Args>(valArgs)...) {}
+        };
+
+    private:
+        mDynArray<Node**, Allocator> mSegments;
+        uint64_t mSize;
+        uint64_t mLevelBuckets; // Bucket count at the start of the current level
+        uint64_t mSplit;        // Next bucket to split, buckets below it are already split this level
+        uint64_t mMaxLoad;
+
+    public:
+        mLinearDictionary(const Allocator& allocator = Allocator())
+            : Storage(allocator), mSegments(allocator), mSize(0), mLevelBuckets(InitialBuckets), mSplit(0), mMaxLoad(MaxLoad)
+        {
+            AddSegment();
+        }
+
+        mLinearDictionary(const mLinearDictionary&) = delete;
+        mLinearDictionary& operator=(const mLinearDictionary&) = delete;
+
+        ~mLinearDictionary()
+        {
+            clear();
+
+            for (uint64_t i = 0; i < mSegments.size(); i++)
+                this->template Deallocate<Node*>(mSegments[i], SegmentSize);
+        }
+
+        using Storage::allocator;
+
+    public: // Access Operators
+        Val& operator[](const Key& key)
+        {
+            uint64_t hash = Utils::Hash(key);
+            Node* node = Find(key, hash);
+            if (node) return node->value;
+
+            return Add(key, hash)->value;
+        }
+
+        const Val& operator[](const Key& key) const
+        {
+            const Val* val = find(key);
+            mAssert(val, "Key not in hash table!");
+
+            return *val;
+        }
+
+        Val* find(const Key& key)
+        {
+            Node* node = Find(key, Utils::Hash(key));
+            return node ? &node->value : nullptr;
+        }
+        const Val* find(const Key& key) const
+        {
+            Node* node = Find(key, Utils::Hash(key));
+            return node ? &node->value : nullptr;
+        }
+
+        bool contains(const Key& key) const { return Find(key, Utils::Hash(key)) != nullptr; }
+
+        // Full hash of a key, for the *_hashed methods
+        uint64_t hash_key(const Key& key) const { return Utils::Hash(key); }
+
+        Val* find_hashed(const Key& key, uint64_t hash)
+        {
+            Node* node = Find(key, hash);
+            return node ? &node->value : nullptr;
+        }
+        const Val* find_hashed(const Key& key, uint64_t hash) const
+        {
+            Node* node = Find(key, hash);
+            return node ? &node->value : nullptr;
+        }
+
+    public: // Iterator Methods
+        // Calls fn(key, value) for every entry, in bucket order
+        template<typename Fn>
+        void forEach(Fn&& fn)
+        {
+            for (uint64_t i = 0; i < bucketCount(); i++)
+                for (Node* node = Head(i); node; node = node->next)
+                    fn(node->key, node->value);
+        }
+
+    public: // Element Modifiers
+        // Returns the existing value if the key is already present
+        Val& insert(const Key& key, const Val& val)
+        {
+            uint64_t hash = Utils::Hash(key);
+            Node* node = Find(key, hash);
+            if (node) return node->value;
+
+            return Add(key, hash, val)->value;
+        }
+
+        template<typename... Args>
+        Val& emplace(const Key& key, Args&&... args)
+        {
+            uint64_t hash = Utils::Hash(key);
+            Node* node = Find(key, hash);
+            if (node) return node->value;
+
+            return Add(key, hash, std::forward<Args>(args)...)->value;
+        }
+
+        // emplace with a hash from hash_key()
+        template<typename... Args>
+        Val& insert_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Node* node = Find(key, hash);
+            if (node) return node->value;
+
+            return Add(key, hash, std::forward<Args>(args)...)->value;
+        }
+
+        // Like emplace, but also reports whether the value was inserted
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            return try_emplace_hashed(key, Utils::Hash(key), std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<Val*, bool> try_emplace_hashed(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Node* node = Find(key, hash);
+            if (node) return { &node->value, false };
+
+            return { &Add(key, hash, std::forward<Args>(args)...)->value, true };
+        }
+
+        bool erase(const Key& key)
+        {
+            uint64_t hash = Utils::Hash(key);
+            for (Node** link = &Head(BucketOf(hash)); *link; link = &(*link)->next)
+            {
+                Node* node = *link;
+                if (node->hash != hash || !(node->key == key)) continue;
+
+                *link = node->next;
+                Destroy(node);
+                mSize--;
+                return true;
+            }
+
+            return false;
+        }
+
+        // Removes every entry, the buckets stay allocated
+        void clear()
+        {
+            for (uint64_t i = 0; i < bucketCount(); i++)
+            {
+                Node*& head = Head(i);
+                while (head)
+                {
+                    Node* next = head->next;
+                    Destroy(head);
+                    head = next;
+                }
+            }
+
+            mSize = 0;
+        }
+
+    public:
+        uint64_t size() const { return mSize; }
+        uint64_t bucketCount() const { return mLevelBuckets + mSplit; }
+
+    private: // Underlying Element Modifier Methods
+        template<typename... Args>
+        Node* Add(const Key& key, uint64_t hash, Args&&... args)
+        {
+            Node*& head = Head(BucketOf(hash));
+            head = Memory::Emplace<Node>(this->template Allocate<Node>(1), head, hash, key, std::forward<Args>(args)...);
+            Node* node = head;
+
+            if (++mSize > mMaxLoad * bucketCount()) Split();
+
+            return node;
+        }
+
+        void Destroy(Node* node)
+        {
+            node->~Node();
+            this->template Deallocate<Node>(node, 1);
+        }
+
+    private: // Hashing Related Methods
+        uint64_t BucketOf(uint64_t hash) const
+        {
+            uint64_t bucket = hash & (mLevelBuckets - 1);
+            if (bucket < mSplit) bucket = hash & (2 * mLevelBuckets - 1);
+
+            return bucket;
+        }
+
+        Node* Find(const Key& key, uint64_t hash) const
+        {
+            for (Node* node = Head(BucketOf(hash)); node; node = node->next)
+                if (node->hash == hash && node->key == key) return node;
+
+            return nullptr;
+        }
+
+        // Moves the entries of the bucket under the split pointer whose next hash bit is set into a new
+        // bucket at the end, then advances the pointer
+        void Split()
+        {
+            uint64_t target = mLevelBuckets + mSplit;
+            if (target % SegmentSize == 0 && target / SegmentSize == mSegments.size()) AddSegment();
+
+            Node* node = Head(mSplit);
+            Node** keep = &Head(mSplit);
+            Node** move = &Head(target);
+            while (node)
+            {
+                Node* next = node->next;
+                Node**& tail = (node->hash & mLevelBuckets) ? move : keep;
+                *tail = node;
+                tail = &node->next;
+                node = next;
+            }
+            *keep = nullptr;
+            *move = nullptr;
+
+            if (++mSplit == mLevelBuckets)
+            {
+                mLevelBuckets *= 2;
+                mSplit = 0;
+            }
+        }
+
+        void AddSegment()
+        {
+            Node** segment = this->template Allocate<Node*>(SegmentSize);
+            Memory::SetZero<Node*>(segment, SegmentSize);
+            mSegments.emplace_back(segment);
+        }
+
+        Node*& Head(uint64_t bucket) { return mSegments[bucket / SegmentSize][bucket % SegmentSize]; }
+        Node* Head(uint64_t bucket) const { return mSegments[bucket / SegmentSize][bucket % SegmentSize]; }
+    };
+
+}
\ No newline at end of file
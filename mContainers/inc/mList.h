@@ -98,8 +98,8 @@ namespace mContainers {
 
 	};
 
-	template<typename T>
-	class mList
+	template<typename T, typename Allocator = Memory>
+	class mList : private mAllocatorStorage<Allocator>
 	{
 	public:
 		struct Node
@@ -122,39 +122,88 @@ namespace mContainers {
 		};
 
 	public:
-		using mListType = mList<T>;
+		using mListType = mList<T, Allocator>;
 		using Iterator = mListIterator<mListType>;
 		using ValType = T;
 		using NodeType = Node;
+		using AllocatorType = Allocator;
 
 	private:
+		using Storage = mAllocatorStorage<Allocator>;
+
 		Node* mHead;
 		uint64_t mSize;
 
 	public:
 		mList() : mHead(nullptr), mSize(0) {}
 
-		mList(uint64_t count)
-			: mHead(nullptr), mSize(0)
+		explicit mList(const Allocator& allocator)
+			: Storage(allocator), mHead(nullptr), mSize(0) {}
+
+		mList(uint64_t count, const Allocator& allocator = Allocator())
+			: Storage(allocator), mHead(nullptr), mSize(0)
 		{
 			if (count == 0) return;
 
-			for (mSize = 0; mSize < count; mSize++)
+			for (uint64_t i = 0; i < count; i++)
 				emplace_front();
 		}
 
-		mList(uint64_t count, const T& val)
-			: mHead(nullptr), mSize(0)
+		mList(uint64_t count, const T& val, const Allocator& allocator = Allocator())
+			: Storage(allocator), mHead(nullptr), mSize(0)
 		{
-			for (mSize = 0; mSize < count; mSize++)
+			for (uint64_t i = 0; i < count; i++)
 				push_front(val);
 		}
 
+		// Copies keep the order of the elements and share the allocator
+		mList(const mList& other)
+			: Storage(other.allocator()), mHead(nullptr), mSize(0)
+		{
+			Node** tail = &mHead;
+			for (Node* node = other.mHead; node; node = node->next)
+			{
+				*tail = NewNode(nullptr, node->data);
+				tail = &(*tail)->next;
+				mSize++;
+			}
+		}
+
+		mList(mList&& other)
+			: Storage(other.allocator()), mHead(other.mHead), mSize(other.mSize)
+		{
+			other.mHead = nullptr;
+			other.mSize = 0;
+		}
+
+		mList& operator=(const mList& other)
+		{
+			if (this == &other) return *this;
+
+			mList copy(other);
+			swap(copy);
+			return *this;
+		}
+		mList& operator=(mList&& other)
+		{
+			swap(other);
+			return *this;
+		}
+
 		~mList()
 		{
 			clear();
 		}
 
+		void swap(mList& other)
+		{
+			std::swap(mHead, other.mHead);
+			std::swap(mSize, other.mSize);
+			std::swap(allocator(), other.allocator());
+		}
+
+		using Storage::allocator;
+
 		T& front() { return mHead->data; }
 		const T& front() const { return mHead->data; }
 
@@ -170,14 +219,14 @@ namespace mContainers {
 
 		void clear()
 		{
-			for (uint64_t i = 0; i < mSize; i++)
+			while (mHead)
 				pop_front();
 			mSize = 0;
 		}
 
 		T& insert_after(Iterator pos, const T& value)
 		{
-			Node* newNode = new Node(pos->next, value);
+			Node* newNode = NewNode(pos->next, value);
 			pos->next = newNode;
 			mSize++;
 
@@ -186,7 +235,7 @@ namespace mContainers {
 
 		T& push_front(const T& value)
 		{
-			Node* newNode = new Node(mHead, value);
+			Node* newNode = NewNode(mHead, value);
 			mHead = newNode;
 			mSize++;
 
@@ -195,7 +244,7 @@ namespace mContainers {
 
 		T& push_front(T&& value)
 		{
-			Node* newNode = new Node(mHead, std::move(value));
+			Node* newNode = NewNode(mHead, std::move(value));
 			mHead = newNode;
 			mSize++;
 
@@ -208,13 +257,24 @@ namespace mContainers {
 
 			Node* temp = mHead;
 			mHead = mHead->next;
-			delete temp;
+			DeleteNode(temp);
+			mSize--;
+		}
+
+		void erase_after(Iterator pos)
+		{
+			Node* target = pos->next;
+			if (!target) return;
+
+			pos->next = target->next;
+			DeleteNode(target);
+			mSize--;
 		}
 
 		template<typename... Args>
 		T& emplace_after(Iterator pos, Args&&... args)
 		{
-			Node* newNode = new Node(pos->next, std::forward<Args>(args)...);
+			Node* newNode = NewNode(pos->next, std::forward<Args>(args)...);
 			pos->next = newNode;
 			mSize++;
 
@@ -224,7 +284,7 @@ namespace mContainers {
 		template<typename... Args>
 		T& emplace_front(Args&&... args)
 		{
-			Node* newNode = new Node(mHead, std::forward<Args>(args)...);
+			Node* newNode = NewNode(mHead, std::forward<Args>(args)...);
 			mHead = newNode;
 			mSize++;
 
@@ -243,6 +303,23 @@ namespace mContainers {
 		{
 			return find(begin(), end(), value);
 		}
+
+	private:
+		template<typename... Args>
+		Node* NewNode(Node* next, Args&&... args)
+		{
+			return Memory::Emplace<Node>(this->template Allocate<Node>(1), next, std::forward<Args>(args)...);
+		}
+
+		void DeleteNode(Node* node)
+		{
+			node->~Node();
+			this->template Deallocate<Node>(node, 1);
+		}
 	};
 
+	// Only holds a pointer to its first node
+	template<typename T, typename Allocator>
+	struct mIsTriviallyRelocatable<mList<T, Allocator>> : mIsTriviallyRelocatable<Allocator> {};
+
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mSpan.h"
+
+#include "mUtils.h"
+
+namespace mContainers {
+
+    // Dictionary mapping each key to a group of values. Groups of up to InlineCount values are stored
+    // inside the group itself, larger groups own a contiguous slice of one shared value pool, so
+    // equal_range() is always a single span. Growing a slice that is not at the end of the pool moves it
+    // to the end, leaving the old slots as waste until compact() rewrites the pool in group order (CSR layout).
+    // Key and Value type must be default constructable. The allocator is shared by the groups, buckets and pool.
+    template<typename Key, typename Val, uint64_t InlineCount = 2, uint64_t MaxLoad = 1, typename Allocator = Memory>
+    class mMultiDictionary
+    {
+    private:
+        mStaticAssert(InlineCount > 0, "Groups need at least one inline value!")
+
+        static constexpr uint64_t NoGroup = (uint64_t)-1;
+
+        struct Group
+        {
+            Key key;
+            uint64_t hash;
+            uint64_t next;      // Next group in the same bucket
+            uint64_t offset;    // Start of the pool slice once spilled
+            uint64_t count;
+            uint64_t capacity;  // Pool slice capacity, 0 while values are inline
+            Val values[InlineCount];
+
+            Group() : key(), hash(0), next(NoGroup), offset(0), count(0), capacity(0), values() {}
+            Group(const Key& _key, uint64_t _hash, uint64_t _next)
+                : key(_key), hash(_hash), next(_next), offset(0), count(0), capacity(0), values() {}
+
+            bool spilled() const { return capacity != 0; }
+        };
+
+    private:
+        mDynArray<Group, Allocator> mGroups;
+        mDynArray<uint64_t, Allocator> mBuckets;   // Index of the first group in each bucket
+        mDynArray<Val, Allocator> mPool;
+        uint64_t mSize;
+        uint64_t mWasted;
+        uint64_t mBucketCount;
+        uint64_t mMaxLoad;
+
+    public:
+        mMultiDictionary(const Allocator& allocator = Allocator())
+            : mGroups(allocator), mBuckets(DEFAULT_BUCKETS, NoGroup, allocator), mPool(allocator), mSize(0), mWasted(0),
+            mBucketCount(DEFAULT_BUCKETS), mMaxLoad(MaxLoad) {}
+
+        const Allocator& allocator() const { return mGroups.allocator(); }
+
+    public: // Access Operators
+        // Span over every value stored for key, empty if the key is not present.
+        // The span is invalidated by the next insertion or compaction.
+        mSpan<Val> equal_range(const Key& key)
+        {
+            uint64_t index = FindGroup(key, Utils::Hash(key));
+            if (index == NoGroup) return mSpan<Val>();
+
+            return Values(mGroups[index]);
+        }
+        mSpan<const Val> equal_range(const Key& key) const
+        {
+            uint64_t index = FindGroup(key, Utils::Hash(key));
+            if (index == NoGroup) return mSpan<const Val>();
+
+            const Group& group = mGroups[index];
+            return mSpan<const Val>(group.spilled() ? &mPool[group.offset] : group.values, group.count);
+        }
+
+        uint64_t count(const Key& key) const
+        {
+            uint64_t index = FindGroup(key, Utils::Hash(key));
+            return index == NoGroup ? 0 : mGroups[index].count;
+        }
+
+        bool contains(const Key& key) const
+        {
+            return FindGroup(key, Utils::Hash(key)) != NoGroup;
+        }
+
+    public: // Iterator Methods
+        // Calls fn(key, span) for each key, in insertion order of the keys.
+        template<typename Fn>
+        void forEach(Fn&& fn)
+        {
+            for (uint64_t i = 0; i < mGroups.size(); i++)
+                fn((const Key&)mGroups[i].key, Values(mGroups[i]));
+        }
+
+    public: // Element Modifiers
+        Val& insert(const Key& key, const Val& val)
+        {
+            Val& slot = Append(key);
+            slot = val;
+            return slot;
+        }
+
+        template<typename... Args>
+        Val& emplace(const Key& key, Args&&... args)
+        {
+            Val& slot = Append(key);
+            slot = Val(std::forward<Args>(args)...);
+            return slot;
+        }
+
+        // Removes the key and all of its values. The last group is moved into the freed slot.
+        void erase(const Key& key)
+        {
+            uint64_t hash = Utils::Hash(key);
+            uint64_t index = FindGroup(key, hash);
+            if (index == NoGroup) return;
+
+            Group& group = mGroups[index];
+            mSize -= group.count;
+            mWasted += group.capacity;
+            Unlink(index);
+
+            uint64_t last = mGroups.size() - 1;
+            if (index != last)
+            {
+                Unlink(last);
+                mGroups[index] = std::move(mGroups[last]);
+                uint64_t& head = mBuckets[mGroups[index].hash % mBucketCount];
+                mGroups[index].next = head;
+                head = index;
+            }
+            mGroups.pop_back();
+        }
+
+        // Rewrites the pool so spilled groups are packed back to back in group order, and moves
+        // groups that shrank to InlineCount or fewer values back inline.
+        void compact()
+        {
+            mDynArray<Val, Allocator> pool(mPool.allocator());
+            pool.reserve(mPool.size() - mWasted);
+
+            for (uint64_t i = 0; i < mGroups.size(); i++)
+            {
+                Group& group = mGroups[i];
+                if (!group.spilled()) continue;
+
+                if (group.count <= InlineCount)
+                {
+                    for (uint64_t j = 0; j < group.count; j++)
+                        group.values[j] = std::move(mPool[group.offset + j]);
+                    group.capacity = 0;
+                    continue;
+                }
+
+                uint64_t offset = pool.size();
+                for (uint64_t j = 0; j < group.count; j++)
+                    pool.emplace_back(std::move(mPool[group.offset + j]));
+                group.offset = offset;
+                group.capacity = group.count;
+            }
+
+            mPool.swap(pool);
+            mWasted = 0;
+        }
+
+        void clear()
+        {
+            mGroups.clear();
+            mPool.clear();
+            mBuckets.clear();
+            mBuckets.resize(mBucketCount, NoGroup);
+            mSize = 0;
+            mWasted = 0;
+        }
+
+    public:
+        uint64_t size() const { return mSize; }
+        uint64_t keyCount() const { return mGroups.size(); }
+        uint64_t wasted() const { return mWasted; }
+
+    private: // Underlying Element Modifier Methods
+        // Returns the slot for a new value at the end of the key's group, creating the group if needed.
+        Val& Append(const Key& key)
+        {
+            uint64_t hash = Utils::Hash(key);
+            uint64_t index = FindGroup(key, hash);
+            if (index == NoGroup)
+            {
+                if ((mGroups.size() / mBucketCount) >= mMaxLoad) ReHash();
+
+                uint64_t& head = mBuckets[hash % mBucketCount];
+                mGroups.emplace_back(key, hash, head);
+                index = head = mGroups.size() - 1;
+            }
+
+            Group& group = mGroups[index];
+            mSize++;
+
+            if (!group.spilled())
+            {
+                if (group.count < InlineCount) return group.values[group.count++];
+
+                Spill(group);
+            }
+            else if (group.count == group.capacity)
+                Grow(group);
+
+            return mPool[group.offset + group.count++];
+        }
+
+        void Spill(Group& group)
+        {
+            uint64_t capacity = 2 * InlineCount;
+            ReservePool(capacity);
+            group.offset = mPool.size();
+            for (uint64_t i = 0; i < group.count; i++)
+                mPool.emplace_back(std::move(group.values[i]));
+            for (uint64_t i = group.count; i < capacity; i++)
+                mPool.emplace_back();
+
+            group.capacity = capacity;
+        }
+
+        void Grow(Group& group)
+        {
+            uint64_t capacity = 2 * group.capacity;
+            ReservePool(capacity);
+
+            // A slice at the end of the pool can grow in place, otherwise it moves to the end
+            if (group.offset + group.capacity != mPool.size())
+            {
+                uint64_t offset = mPool.size();
+                for (uint64_t i = 0; i < group.count; i++)
+                    mPool.emplace_back(std::move(mPool[group.offset + i]));
+
+                mWasted += group.capacity;
+                group.offset = offset;
+                for (uint64_t i = group.count; i < capacity; i++)
+                    mPool.emplace_back();
+            }
+            else
+            {
+                for (uint64_t i = group.capacity; i < capacity; i++)
+                    mPool.emplace_back();
+            }
+
+            group.capacity = capacity;
+        }
+
+        // Values are moved within the pool, so it must not reallocate part way through
+        void ReservePool(uint64_t extra)
+        {
+            if (mPool.size() + extra > mPool.capacity())
+                mPool.reserve(2 * mPool.capacity() + extra);
+        }
+
+        mSpan<Val> Values(Group& group)
+        {
+            return mSpan<Val>(group.spilled() ? &mPool[group.offset] : group.values, group.count);
+        }
+
+    private: // Hashing Related Methods
+        uint64_t FindGroup(const Key& key, uint64_t hash) const
+        {
+            uint64_t index = mBuckets[hash % mBucketCount];
+            while (index != NoGroup)
+            {
+                const Group& group = mGroups[index];
+                if (group.hash == hash && group.key == key) return index;
+                index = group.next;
+            }
+
+            return NoGroup;
+        }
+
+        void Unlink(uint64_t index)
+        {
+            uint64_t* link = &mBuckets[mGroups[index].hash % mBucketCount];
+            while (*link != index)
+                link = &mGroups[*link].next;
+
+            *link = mGroups[index].next;
+        }
+
+        void ReHash()
+        {
+            mBucketCount = Utils::NextPrime(mBucketCount * 2);
+            mBuckets.clear();
+            mBuckets.resize(mBucketCount, NoGroup);
+
+            for (uint64_t i = 0; i < mGroups.size(); i++)
+            {
+                uint64_t& head = mBuckets[mGroups[i].hash % mBucketCount];
+                mGroups[i].next = head;
+                head = i;
+            }
+        }
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mThreadPool.h"
+
+namespace mContainers {
+
+	// Data parallel algorithms on the shared thread pool. Ranges are anything with data() and size() (mDynArray,
+	// mBlock, mSpan, mSmallArray), split into contiguous chunks of at least PARALLEL_GRAIN elements. There are a
+	// few chunks per thread so threads finishing early take the remaining ones, and inputs too small for two
+	// chunks run serially on the caller, as do calls made from inside a pool task.
+	namespace Parallel {
+
+		constexpr uint64_t TasksPerThread = 4;
+		constexpr uint64_t CacheLine = 64;
+
+		// Elements of T per cache line, chunk boundaries are rounded to it so no two tasks write the same line
+		template<typename T>
+		constexpr uint64_t LineElements = CacheLine % sizeof(T) == 0 ? CacheLine / sizeof(T) : 1;
+
+		// Number of chunks count elements are split into
+		inline uint64_t TaskCount(uint64_t count, uint64_t grain = PARALLEL_GRAIN, uint64_t perThread = TasksPerThread)
+		{
+			if (count == 0) return 0;
+
+			const uint64_t tasks = count / (grain > 0 ? grain : 1);
+			const uint64_t limit = mThreadPool::Get().size() * perThread;
+			if (tasks <= 1 || limit <= perThread) return 1;
+
+			return tasks < limit ? tasks : limit;
+		}
+
+		// First element of chunk task, the chunks of [0, count) end where the next one begins
+		inline uint64_t TaskBegin(uint64_t count, uint64_t tasks, uint64_t task, uint64_t align = 1)
+		{
+			if (task >= tasks) return count;
+
+			return count * task / tasks / align * align;
+		}
+
+		// Calls fn(first, last) for each chunk of [0, count)
+		template<typename Fn>
+		void ForChunks(uint64_t count, Fn&& fn, uint64_t grain = PARALLEL_GRAIN, uint64_t align = 1)
+		{
+			const uint64_t tasks = TaskCount(count, grain);
+			mThreadPool::Get().run(tasks, [&](uint64_t task)
+			{
+				fn(TaskBegin(count, tasks, task, align), TaskBegin(count, tasks, task + 1, align));
+			});
+		}
+
+		// Calls fn(index) for every index in [0, count). A smaller grain spreads out expensive iterations.
+		template<typename Fn>
+		void For(uint64_t count, Fn&& fn, uint64_t grain = PARALLEL_GRAIN)
+		{
+			ForChunks(count, [&](uint64_t first, uint64_t last)
+			{
+				for (uint64_t i = first; i < last; i++)
+					fn(i);
+			}, grain);
+		}
+
+		// output[i] = fn(input[i]), output must be at least as large as input and may be the input itself
+		template<typename In, typename Out, typename Fn>
+		void Transform(const In& input, Out&& output, Fn&& fn)
+		{
+			mAssert(output.size() >= input.size(), "Output is smaller than the input!");
+
+			auto* src = input.data();
+			auto* dst = output.data();
+			using OutType = std::remove_pointer_t<decltype(dst)>;
+
+			ForChunks(input.size(), [&](uint64_t first, uint64_t last)
+			{
+				for (uint64_t i = first; i < last; i++)
+					dst[i] = fn(src[i]);
+			}, PARALLEL_GRAIN, LineElements<OutType>);
+		}
+
+		// Folds the elements into init with op(T, T), which must be associative. Each chunk is folded
+		// separately, starting from its first element, and the chunk results are combined in order, so op need
+		// not be commutative.
+		template<typename Range, typename T, typename Op>
+		T Reduce(const Range& range, T init, Op&& op)
+		{
+			const auto* data = range.data();
+			const uint64_t count = range.size();
+			const uint64_t tasks = TaskCount(count);
+
+			mDynArray<T> partials(tasks, init);
+			mThreadPool::Get().run(tasks, [&](uint64_t task)
+			{
+				uint64_t first = TaskBegin(count, tasks, task), last = TaskBegin(count, tasks, task + 1);
+				if (first == last) return;
+
+				T partial = data[first];
+				for (uint64_t i = first + 1; i < last; i++)
+					partial = op(std::move(partial), data[i]);
+				partials[task] = std::move(partial);
+			});
+
+			for (uint64_t task = 0; task < tasks; task++)
+				if (TaskBegin(count, tasks, task) != TaskBegin(count, tasks, task + 1))
+					init = op(std::move(init), partials[task]);
+
+			return init;
+		}
+
+		template<typename Range, typename Pred>
+		uint64_t CountIf(const Range& range, Pred&& pred)
+		{
+			const auto* data = range.data();
+			const uint64_t count = range.size();
+			const uint64_t tasks = TaskCount(count);
+
+			mDynArray<uint64_t> partials(tasks, 0);
+			mThreadPool::Get().run(tasks, [&](uint64_t task)
+			{
+				uint64_t matches = 0;
+				for (uint64_t i = TaskBegin(count, tasks, task); i < TaskBegin(count, tasks, task + 1); i++)
+					matches += pred(data[i]) ? 1 : 0;
+				partials[task] = matches;
+			});
+
+			uint64_t matches = 0;
+			for (uint64_t task = 0; task < tasks; task++)
+				matches += partials[task];
+
+			return matches;
+		}
+
+		// Index of the first smallest element, size() if the range is empty
+		template<typename Range, typename Less = std::less<>>
+		uint64_t MinElement(const Range& range, Less&& less = Less())
+		{
+			const auto* data = range.data();
+			const uint64_t count = range.size();
+			const uint64_t tasks = TaskCount(count);
+
+			mDynArray<uint64_t> partials(tasks, count);
+			mThreadPool::Get().run(tasks, [&](uint64_t task)
+			{
+				uint64_t first = TaskBegin(count, tasks, task), last = TaskBegin(count, tasks, task + 1);
+				if (first == last) return;
+
+				uint64_t best = first;
+				for (uint64_t i = first + 1; i < last; i++)
+					if (less(data[i], data[best])) best = i;
+				partials[task] = best;
+			});
+
+			uint64_t best = count;
+			for (uint64_t task = 0; task < tasks; task++)
+			{
+				uint64_t index = partials[task];
+				if (index != count && (best == count || less(data[index], data[best]))) best = index;
+			}
+
+			return best;
+		}
+
+		// How many of the first k elements of the stable merge of sorted a and b come from a, found by binary
+		// search so a merge can be split at any output position
+		template<typename T, typename Less>
+		uint64_t MergeSplit(const T* a, uint64_t aCount, const T* b, uint64_t bCount, uint64_t k, Less& less)
+		{
+			uint64_t low = k > bCount ? k - bCount : 0;
+			uint64_t high = k < aCount ? k : aCount;
+			while (low < high)
+			{
+				uint64_t i = (low + high) / 2;
+				if (!less(b[k - i - 1], a[i])) low = i + 1;
+				else high = i;
+			}
+
+			return low;
+		}
+
+		// Sorts the chunks on their own, then merges pairs of sorted runs until one is left. Merges ping-pong
+		// between the data and a scratch copy, with each merge split into independent pieces by MergeSplit so
+		// every round, including the last, uses the whole pool. The merge is stable, so sorting the chunks with
+		// a stable sort makes the whole sort stable.
+		template<bool Stable, typename T, typename Less>
+		void MergeSort(T* data, uint64_t count, Less& less)
+		{
+			mThreadPool& pool = mThreadPool::Get();
+			uint64_t runs = TaskCount(count, PARALLEL_GRAIN, 1);
+			if (runs <= 1)
+			{
+				if constexpr (Stable) std::stable_sort(data, data + count, less);
+				else std::sort(data, data + count, less);
+				return;
+			}
+
+			mDynArray<uint64_t> bounds(runs + 1);
+			for (uint64_t run = 0; run <= runs; run++)
+				bounds[run] = TaskBegin(count, runs, run);
+
+			pool.run(runs, [&](uint64_t run)
+			{
+				if constexpr (Stable) std::stable_sort(data + bounds[run], data + bounds[run + 1], less);
+				else std::sort(data + bounds[run], data + bounds[run + 1], less);
+			});
+
+			// The first round merges out of the scratch copy back into data
+			T* scratch = Memory::Alloc<T>(count);
+			ForChunks(count, [&](uint64_t first, uint64_t last)
+			{
+				for (uint64_t i = first; i < last; i++)
+					Memory::Emplace<T>(&scratch[i], std::move(data[i]));
+			});
+
+			T* src = scratch;
+			T* dst = data;
+			while (runs > 1)
+			{
+				const uint64_t pairs = (runs + 1) / 2;
+				const uint64_t pieces = (pool.size() + pairs - 1) / pairs;
+
+				pool.run(pairs * pieces, [&](uint64_t task)
+				{
+					const uint64_t pair = task / pieces, piece = task % pieces;
+					const uint64_t aBegin = bounds[2 * pair], bBegin = bounds[2 * pair + 1];
+					const uint64_t bEnd = bounds[2 * pair + 2 < runs ? 2 * pair + 2 : runs];
+
+					const T* a = src + aBegin;
+					const T* b = src + bBegin;
+					const uint64_t aCount = bBegin - aBegin, bCount = bEnd - bBegin;
+					const uint64_t first = (aCount + bCount) * piece / pieces, last = (aCount + bCount) * (piece + 1) / pieces;
+
+					uint64_t aFirst = MergeSplit(a, aCount, b, bCount, first, less);
+					uint64_t aLast = MergeSplit(a, aCount, b, bCount, last, less);
+					std::merge(std::make_move_iterator(src + aBegin + aFirst), std::make_move_iterator(src + aBegin + aLast),
+						std::make_move_iterator(src + bBegin + first - aFirst), std::make_move_iterator(src + bBegin + last - aLast),
+						dst + aBegin + first, less);
+				});
+
+				for (uint64_t pair = 0; pair <= pairs; pair++)
+					bounds[pair] = bounds[2 * pair < runs ? 2 * pair : runs];
+				runs = pairs;
+				std::swap(src, dst);
+			}
+
+			ForChunks(count, [&](uint64_t first, uint64_t last)
+			{
+				for (uint64_t i = first; i < last; i++)
+				{
+					if (src == scratch) data[i] = std::move(scratch[i]);
+					scratch[i].~T();
+				}
+			});
+			Memory::Free<T>(scratch, count);
+		}
+
+		template<typename Range, typename Less = std::less<>>
+		void Sort(Range&& range, Less&& less = Less())
+		{
+			MergeSort<false>(range.data(), range.size(), less);
+		}
+
+		// Equal elements keep their order
+		template<typename Range, typename Less = std::less<>>
+		void StableSort(Range&& range, Less&& less = Less())
+		{
+			MergeSort<true>(range.data(), range.size(), less);
+		}
+
+	}
+
+}
\ No newline at end of file
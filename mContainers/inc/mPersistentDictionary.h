@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mDictionary.h"
+
+#if defined(M_PLATFORM_WINDOWS)
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace mContainers {
+
+    // Restart safe dictionary. Every mutation is appended to <path>.log, buffered in memory and written out
+    // with one fdatasync per PERSIST_SYNC_RECORDS mutations (group commit) or on commit(). checkpoint()
+    // writes the whole table to <path>.snap and empties the log. On construction the snapshot is mapped and
+    // loaded, then the log is replayed up to the first torn or corrupt record. Erasures are logged as
+    // tombstones, so Dict must provide erase(key).
+    // Key and Value type must be trivially copyable, they are written to disk as raw bytes.
+    template<typename Key, typename Val, typename Dict = mDictionary<Key, Val>>
+    class mPersistentDictionary
+    {
+    private:
+        // Checked in every build, mStaticAssert is compiled out with the other asserts
+        static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Val>, "Persisted types must be trivially copyable!");
+
+        static constexpr uint64_t SnapshotMagic = 0x50414E536C63746Dull;
+
+        struct SnapshotHeader
+        {
+            uint64_t magic;
+            uint32_t keySize;
+            uint32_t valSize;
+            uint64_t count;
+        };
+
+        struct SnapshotEntry
+        {
+            Key key;
+            Val value;
+        };
+
+        // LogRecord flags
+        static constexpr uint32_t EraseRecord = 1;
+
+        struct LogRecord
+        {
+            Key key;
+            Val value;
+            uint32_t flags;
+            uint32_t checksum;
+
+            LogRecord() { memset(this, 0, sizeof(LogRecord)); }
+            LogRecord(const Key& _key, const Val& _val, uint32_t _flags = 0)
+            {
+                memset(this, 0, sizeof(LogRecord));
+                key = _key;
+                value = _val;
+                flags = _flags;
+                checksum = Checksum();
+            }
+
+            // FNV-1a over the key, value and flag bytes
+            uint32_t Checksum() const
+            {
+                uint32_t hash = 2166136261u;
+                hash = Fold(hash, &key, sizeof(Key));
+                hash = Fold(hash, &value, sizeof(Val));
+                return Fold(hash, &flags, sizeof(flags));
+            }
+
+            static uint32_t Fold(uint32_t hash, const void* data, uint64_t size)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                for (uint64_t i = 0; i < size; i++)
+                    hash = (hash ^ bytes[i]) * 16777619u;
+
+                return hash;
+            }
+        };
+
+    private:
+        Dict mDict;
+        std::string mPath;
+        std::FILE* mLog;
+        mDynArray<LogRecord> mPending;  // Logged but not yet written
+        uint64_t mSyncRecords;
+        uint64_t mLogSize;              // Bytes of complete records in the log
+
+    public:
+        mPersistentDictionary(const std::string& path, uint64_t syncRecords = PERSIST_SYNC_RECORDS)
+            : mPath(path), mLog(nullptr), mSyncRecords(syncRecords), mLogSize(0)
+        {
+            mAssert(syncRecords > 0, "Sync interval must be at least one record!");
+
+            Recover();
+            mLog = std::fopen(LogPath().c_str(), "ab");
+        }
+
+        mPersistentDictionary(const mPersistentDictionary&) = delete;
+        mPersistentDictionary& operator=(const mPersistentDictionary&) = delete;
+
+        ~mPersistentDictionary()
+        {
+            if (!mLog) return;
+
+            commit();
+            std::fclose(mLog);
+        }
+
+    public: // Access Operators
+        // Lookups only, every change has to go through the logged modifiers below
+        const Dict& dictionary() const { return mDict; }
+
+        // False if the log could not be opened, mutations are then applied in memory only
+        bool good() const { return mLog != nullptr; }
+
+    public: // Element Modifiers
+        // Sets the value for key, replacing any existing value. The result is read only, a change made
+        // through it would not be logged.
+        const Val& insert(const Key& key, const Val& val)
+        {
+            Val& slot = mDict[key];
+            slot = val;
+            Log(LogRecord(key, val));
+
+            return slot;
+        }
+
+        // Removes key, logging a tombstone so recovery removes it too. Returns false if the key was not present.
+        bool erase(const Key& key)
+        {
+            if (!mDict.erase(key)) return false;
+
+            Log(LogRecord(key, Val(), EraseRecord));
+            return true;
+        }
+
+    public: // Persistence
+        // Writes the pending mutations and waits for them to reach the disk. If that fails they stay pending
+        // and are written again by the next commit().
+        bool commit()
+        {
+            if (!mLog) return false;
+            if (mPending.size() == 0) return true;
+
+            const uint64_t bytes = mPending.size() * sizeof(LogRecord);
+            bool written = std::fwrite(mPending.data(), sizeof(LogRecord), mPending.size(), mLog) == mPending.size() &&
+                std::fflush(mLog) == 0 && SyncFile(mLog);
+
+            if (written)
+            {
+                mLogSize += bytes;
+                mPending.clear();
+                return true;
+            }
+
+            // Replay stops at a torn record, so anything appended after one would be lost. Cut the log back
+            // to the last complete record, and stop logging if that is not possible.
+            std::fclose(mLog);
+            mLog = TruncateLog(mLogSize) ? std::fopen(LogPath().c_str(), "ab") : nullptr;
+            return false;
+        }
+
+        // Replaces the snapshot with the current contents and truncates the log. The new snapshot is written
+        // beside the old one and renamed over it, so a crash at any point leaves a loadable snapshot, and
+        // replaying an old log over a newer snapshot only reapplies changes it already holds.
+        bool checkpoint()
+        {
+            if (!commit()) return false;
+
+            std::string tempPath = mPath + ".snap.tmp";
+            std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+            if (!file) return false;
+
+            SnapshotHeader header = { SnapshotMagic, (uint32_t)sizeof(Key), (uint32_t)sizeof(Val), 0 };
+            for (const auto& entry : mDict)
+            {
+                M_NOT_USED(entry);
+                header.count++;
+            }
+
+            bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+            for (const auto& entry : mDict)
+            {
+                SnapshotEntry record;
+                memset(&record, 0, sizeof(record));
+                record.key = Deref(entry).key;
+                record.value = Deref(entry).value;
+                written = written && std::fwrite(&record, sizeof(record), 1, file) == 1;
+            }
+
+            written = written && std::fflush(file) == 0 && SyncFile(file);
+            std::fclose(file);
+            if (!written) return false;
+
+            // The rename is only durable once the directory entry is synced. Until then the old snapshot and
+            // log may come back, which recover to the same contents.
+            std::error_code error;
+            std::filesystem::rename(tempPath, SnapshotPath(), error);
+            if (error || !SyncDirectory(SnapshotPath())) return false;
+
+            std::fclose(mLog);
+            mLog = std::fopen(LogPath().c_str(), "wb");
+            mLogSize = 0;
+            return mLog != nullptr;
+        }
+
+    private: // Recovery
+        void Recover()
+        {
+            ReadFile(SnapshotPath(), [&](const uint8_t* data, uint64_t size)
+            {
+                SnapshotHeader header;
+                if (size < sizeof(header)) return;
+
+                memcpy(&header, data, sizeof(header));
+                if (header.magic != SnapshotMagic || header.keySize != sizeof(Key) || header.valSize != sizeof(Val) ||
+                    size != sizeof(header) + header.count * sizeof(SnapshotEntry)) return;
+
+                Reserve(mDict, header.count, 0);
+                const uint8_t* entries = data + sizeof(header);
+                for (uint64_t i = 0; i < header.count; i++)
+                {
+                    SnapshotEntry entry;
+                    memcpy(&entry, entries + i * sizeof(SnapshotEntry), sizeof(SnapshotEntry));
+                    mDict[entry.key] = entry.value;
+                }
+            });
+
+            uint64_t valid = 0, total = 0;
+            ReadFile(LogPath(), [&](const uint8_t* data, uint64_t size)
+            {
+                total = size;
+                for (; valid + sizeof(LogRecord) <= size; valid += sizeof(LogRecord))
+                {
+                    LogRecord record;
+                    memcpy(&record, data + valid, sizeof(LogRecord));
+                    if (record.checksum != record.Checksum()) break;
+
+                    if (record.flags & EraseRecord) mDict.erase(record.key);
+                    else mDict[record.key] = record.value;
+                }
+            });
+
+            // Drop a torn tail so new records are appended after the last good one
+            mLogSize = valid;
+            if (valid != total) TruncateLog(valid);
+        }
+
+        bool TruncateLog(uint64_t size)
+        {
+            std::error_code error;
+            std::filesystem::resize_file(LogPath(), size, error);
+            return !error;
+        }
+
+        // Calls fn(data, size) with the contents of the file, if it exists and is not empty
+        template<typename Fn>
+        static void ReadFile(const std::string& path, Fn&& fn)
+        {
+#if defined(M_PLATFORM_WINDOWS)
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return;
+
+            std::fseek(file, 0, SEEK_END);
+            uint64_t size = (uint64_t)_ftelli64(file);
+            std::fseek(file, 0, SEEK_SET);
+
+            mDynArray<uint8_t> buffer(size);
+            size = std::fread(buffer.data(), 1, size, file);
+            std::fclose(file);
+
+            if (size > 0) fn(buffer.data(), size);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* data = ::mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    ::madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+                    fn(static_cast<const uint8_t*>(data), (uint64_t)info.st_size);
+                    ::munmap(data, (size_t)info.st_size);
+                }
+            }
+            ::close(fd);
+#endif
+        }
+
+        // Buffers a mutation for the log, nothing is kept once the log is unusable
+        void Log(const LogRecord& record)
+        {
+            if (!mLog) return;
+
+            mPending.emplace_back(record);
+            if (mPending.size() >= mSyncRecords) commit();
+        }
+
+        // Flushes the directory holding path, making renames into it durable
+        static bool SyncDirectory(const std::string& path)
+        {
+#if defined(M_PLATFORM_WINDOWS)
+            M_NOT_USED(path);
+            return true; // Directories can't be opened for flushing through the C runtime
+#else
+            std::string directory = std::filesystem::path(path).parent_path().string();
+            int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd < 0) return false;
+
+            bool synced = ::fsync(fd) == 0;
+            ::close(fd);
+            return synced;
+#endif
+        }
+
+        static bool SyncFile(std::FILE* file)
+        {
+#if defined(M_PLATFORM_WINDOWS)
+            return _commit(_fileno(file)) == 0;
+#elif defined(M_PLATFORM_LINUX)
+            return ::fdatasync(fileno(file)) == 0;
+#else
+            return ::fsync(fileno(file)) == 0;
+#endif
+        }
+
+        std::string SnapshotPath() const { return mPath + ".snap"; }
+        std::string LogPath() const { return mPath + ".log"; }
+
+        // Iteration yields entries (dense dictionaries) or pointers to them (mDictionary)
+        template<typename T>
+        static const T& Deref(const T& entry) { return entry; }
+        template<typename T>
+        static const T& Deref(T* entry) { return *entry; }
+
+        // Pre-sizes the table on recovery when the dictionary supports it
+        template<typename D>
+        static auto Reserve(D& dict, uint64_t count, int) -> decltype(dict.reserve(count), void()) { dict.reserve(count); }
+        template<typename D>
+        static void Reserve(D&, uint64_t, long) {}
+    };
+
+}
\ No newline at end of file
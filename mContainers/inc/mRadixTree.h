@@ -0,0 +1,833 @@
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include "mCore.h"
+
+#include "mUtils.h"
+
+#if defined(M_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace mContainers {
+
+	// Byte string view used as an mRadixTree key. Integers are encoded big-endian (with the sign bit flipped
+	// for signed types) so that byte-wise order matches numeric order.
+	class mRadixKey
+	{
+	private:
+		const uint8_t* mData;
+		uint32_t mLength;
+		uint8_t mInline[8];
+
+	public:
+		mRadixKey(const uint8_t* data, uint64_t length)
+			: mData(data), mLength((uint32_t)length) {}
+		mRadixKey(std::string_view str)
+			: mData((const uint8_t*)str.data()), mLength((uint32_t)str.size()) {}
+		mRadixKey(const std::string& str)
+			: mData((const uint8_t*)str.data()), mLength((uint32_t)str.size()) {}
+		mRadixKey(const char* str)
+			: mData((const uint8_t*)str), mLength((uint32_t)strlen(str)) {}
+
+		template<typename Int, typename = std::enable_if_t<std::is_integral_v<Int>>>
+		mRadixKey(Int value)
+			: mData(mInline), mLength(sizeof(Int))
+		{
+			using UInt = std::make_unsigned_t<Int>;
+			UInt bits = (UInt)value;
+			if constexpr (std::is_signed_v<Int>)
+				bits ^= (UInt)1 << (sizeof(Int) * 8 - 1);
+
+			for (uint32_t i = 0; i < sizeof(Int); i++)
+				mInline[i] = (uint8_t)(bits >> ((sizeof(Int) - 1 - i) * 8));
+		}
+
+		mRadixKey(const mRadixKey& other)
+			: mData(other.mData), mLength(other.mLength)
+		{
+			memcpy(mInline, other.mInline, sizeof(mInline));
+			if (other.mData == other.mInline) mData = mInline;
+		}
+
+		uint8_t operator[](uint32_t index) const { return mData[index]; }
+
+		const uint8_t* data() const { return mData; }
+		uint32_t size() const { return mLength; }
+	};
+
+	// Adaptive radix tree (Leis et al.) with Node4/16/48/256 inner nodes and full path compression.
+	// Entries are kept in byte-lexicographic key order, so point lookups, lower bound and prefix scans
+	// only touch the nodes along the key path. A key ending at an inner node is stored as that node's terminal leaf.
+	// Point lookups beat mDictionary at every size measured, and a B-tree from around a million keys up.
+	// The allocator is shared by the nodes, their prefixes and the entry keys.
+	template<typename Val, typename Allocator = Memory>
+	class mRadixTree : private mAllocatorStorage<Allocator>
+	{
+	private:
+		using Storage = mAllocatorStorage<Allocator>;
+
+		enum class NodeType : uint8_t
+		{
+			Leaf, Node4, Node16, Node48, Node256
+		};
+
+		struct Node
+		{
+			NodeType type;
+
+			Node(NodeType _type) : type(_type) {}
+		};
+
+	public:
+		struct Entry : Node
+		{
+		private:
+			friend class mRadixTree; // Allocates and frees the key bytes
+
+			uint8_t* mKey;
+			uint32_t mLength;
+
+		public:
+			Val value;
+
+			template<typename... Args>
+			Entry(uint8_t* keyData, const mRadixKey& key, Args&&... args)
+				: Node(NodeType::Leaf), mKey(keyData), mLength(key.size()), value(std::forward<Args>(args)...)
+			{
+				memcpy(mKey, key.data(), key.size());
+			}
+
+			mRadixKey key() const { return mRadixKey(mKey, mLength); }
+		};
+
+	private:
+		struct Inner : Node
+		{
+			uint16_t count;
+			uint32_t prefixLength;
+			uint8_t* prefix;
+			Entry* terminal;
+
+			Inner(NodeType _type) : Node(_type), count(0), prefixLength(0), prefix(nullptr), terminal(nullptr) {}
+		};
+
+		struct Node4 : Inner
+		{
+			uint8_t keys[4];
+			Node* children[4];
+
+			Node4() : Inner(NodeType::Node4) {}
+		};
+
+		struct Node16 : Inner
+		{
+			uint8_t keys[16];
+			Node* children[16];
+
+			Node16() : Inner(NodeType::Node16) {}
+		};
+
+		struct Node48 : Inner
+		{
+			uint8_t index[256]; // Slot + 1 of the child for each byte, 0 if absent
+			Node* children[48];
+
+			Node48() : Inner(NodeType::Node48)
+			{
+				Memory::SetZero<uint8_t>(index, 256);
+				Memory::SetZero<Node*>(children, 48);
+			}
+		};
+
+		struct Node256 : Inner
+		{
+			Node* children[256];
+
+			Node256() : Inner(NodeType::Node256)
+			{
+				Memory::SetZero<Node*>(children, 256);
+			}
+		};
+
+	private:
+		Node* mRoot;
+		uint64_t mSize;
+
+	public:
+		mRadixTree(const Allocator& allocator = Allocator())
+			: Storage(allocator), mRoot(nullptr), mSize(0) {}
+
+		mRadixTree(const mRadixTree&) = delete;
+		mRadixTree& operator=(const mRadixTree&) = delete;
+
+		~mRadixTree()
+		{
+			clear();
+		}
+
+		using Storage::allocator;
+
+	public: // Access Operators
+		Val* find(const mRadixKey& key)
+		{
+			Entry* entry = FindEntry(key);
+			return entry ? &entry->value : nullptr;
+		}
+		const Val* find(const mRadixKey& key) const
+		{
+			const Entry* entry = FindEntry(key);
+			return entry ? &entry->value : nullptr;
+		}
+
+		bool contains(const mRadixKey& key) const { return FindEntry(key) != nullptr; }
+
+		Val& operator[](const mRadixKey& key)
+		{
+			return Insert(&mRoot, key, 0)->value;
+		}
+
+		// First entry whose key is not less than key, or nullptr if there is none.
+		Entry* lower_bound(const mRadixKey& key)
+		{
+			Entry* result = nullptr;
+			auto first = [&](Entry& entry) { result = &entry; return false; };
+			WalkFrom(mRoot, key, 0, first);
+			return result;
+		}
+
+	public: // Ordered Traversal
+		// Callbacks take an Entry& and may return false to stop the traversal early.
+		template<typename Fn>
+		void forEach(Fn&& fn)
+		{
+			Walk(mRoot, fn);
+		}
+
+		// Visits every entry with key >= from in key order.
+		template<typename Fn>
+		void forEachFrom(const mRadixKey& from, Fn&& fn)
+		{
+			WalkFrom(mRoot, from, 0, fn);
+		}
+
+		// Visits every entry whose key starts with prefix in key order.
+		template<typename Fn>
+		void forEachPrefix(const mRadixKey& prefix, Fn&& fn)
+		{
+			Node* node = mRoot;
+			uint32_t depth = 0;
+			while (node)
+			{
+				if (node->type == NodeType::Leaf)
+				{
+					Entry* entry = static_cast<Entry*>(node);
+					mRadixKey key = entry->key();
+					if (key.size() >= prefix.size() && memcmp(key.data(), prefix.data(), prefix.size()) == 0)
+						Visit(fn, *entry);
+					return;
+				}
+
+				Inner* inner = static_cast<Inner*>(node);
+				uint32_t remaining = prefix.size() - depth;
+				uint32_t compare = remaining < inner->prefixLength ? remaining : inner->prefixLength;
+				if (compare && memcmp(inner->prefix, prefix.data() + depth, compare) != 0) return;
+				if (remaining <= inner->prefixLength)
+				{
+					Walk(node, fn);
+					return;
+				}
+
+				depth += inner->prefixLength;
+				Node** child = FindChild(inner, prefix[depth++]);
+				node = child ? *child : nullptr;
+			}
+		}
+
+	public: // Element Modifiers
+		Val& insert(const mRadixKey& key, const Val& val)
+		{
+			Entry* entry = Insert(&mRoot, key, 0, val);
+			entry->value = val;
+			return entry->value;
+		}
+
+		template<typename... Args>
+		Val& emplace(const mRadixKey& key, Args&&... args)
+		{
+			return Insert(&mRoot, key, 0, std::forward<Args>(args)...)->value;
+		}
+
+		// Inner nodes are not shrunk back to smaller node types, only freed once empty.
+		bool erase(const mRadixKey& key)
+		{
+			if (!Erase(&mRoot, key, 0)) return false;
+
+			mSize--;
+			return true;
+		}
+
+		void clear()
+		{
+			FreeNode(mRoot);
+			mRoot = nullptr;
+			mSize = 0;
+		}
+
+		uint64_t size() const { return mSize; }
+		bool empty() const { return mSize == 0; }
+
+	private: // Lookup Methods
+		Entry* FindEntry(const mRadixKey& key) const
+		{
+			Node* node = mRoot;
+			uint32_t depth = 0;
+			while (node)
+			{
+				if (node->type == NodeType::Leaf)
+				{
+					Entry* entry = static_cast<Entry*>(node);
+					return Matches(entry, key) ? entry : nullptr;
+				}
+
+				Inner* inner = static_cast<Inner*>(node);
+				if (inner->prefixLength)
+				{
+					if (PrefixMismatch(inner, key, depth) != inner->prefixLength) return nullptr;
+					depth += inner->prefixLength;
+				}
+
+				if (depth == key.size()) return inner->terminal;
+
+				Node** child = FindChild(inner, key[depth++]);
+				node = child ? *child : nullptr;
+			}
+
+			return nullptr;
+		}
+
+		static bool Matches(const Entry* entry, const mRadixKey& key)
+		{
+			mRadixKey entryKey = entry->key();
+			return entryKey.size() == key.size() && memcmp(entryKey.data(), key.data(), key.size()) == 0;
+		}
+
+		// Number of leading prefix bytes of the node that match the key from depth
+		static uint32_t PrefixMismatch(const Inner* inner, const mRadixKey& key, uint32_t depth)
+		{
+			uint32_t limit = key.size() - depth;
+			if (limit > inner->prefixLength) limit = inner->prefixLength;
+
+			uint32_t i = 0;
+			while (i < limit && inner->prefix[i] == key[depth + i])
+				i++;
+
+			return i;
+		}
+
+		static Node** FindChild(Inner* inner, uint8_t byte)
+		{
+			switch (inner->type)
+			{
+			case NodeType::Node4:
+			{
+				Node4* node = static_cast<Node4*>(inner);
+				for (uint16_t i = 0; i < node->count; i++)
+					if (node->keys[i] == byte) return &node->children[i];
+				return nullptr;
+			}
+			case NodeType::Node16:
+			{
+				Node16* node = static_cast<Node16*>(inner);
+#if defined(M_SIMD_SSE2)
+				__m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), _mm_loadu_si128((const __m128i*)node->keys));
+				uint32_t mask = (uint32_t)_mm_movemask_epi8(cmp) & ((1u << node->count) - 1);
+				return mask ? &node->children[Utils::CountTrailingZeros(mask)] : nullptr;
+#else
+				for (uint16_t i = 0; i < node->count; i++)
+					if (node->keys[i] == byte) return &node->children[i];
+				return nullptr;
+#endif
+			}
+			case NodeType::Node48:
+			{
+				Node48* node = static_cast<Node48*>(inner);
+				return node->index[byte] ? &node->children[node->index[byte] - 1] : nullptr;
+			}
+			case NodeType::Node256:
+			{
+				Node256* node = static_cast<Node256*>(inner);
+				return node->children[byte] ? &node->children[byte] : nullptr;
+			}
+			default:
+				return nullptr;
+			}
+		}
+
+		// Position of the first key >= byte in a sorted Node4/Node16 key array
+		static uint16_t LowerChild(const uint8_t* keys, uint16_t count, uint8_t byte)
+		{
+#if defined(M_SIMD_SSE2)
+			if (count > 4)
+			{
+				__m128i values = _mm_loadu_si128((const __m128i*)keys);
+				__m128i cmp = _mm_cmpeq_epi8(_mm_max_epu8(values, _mm_set1_epi8((char)byte)), values);
+				uint32_t mask = (uint32_t)_mm_movemask_epi8(cmp) & ((1u << count) - 1);
+				return mask ? (uint16_t)Utils::CountTrailingZeros(mask) : count;
+			}
+#endif
+			uint16_t i = 0;
+			while (i < count && keys[i] < byte)
+				i++;
+
+			return i;
+		}
+
+	private: // Traversal Methods
+		template<typename Fn>
+		static bool Visit(Fn& fn, Entry& entry)
+		{
+			if constexpr (std::is_same_v<decltype(fn(entry)), bool>)
+				return fn(entry);
+			else
+			{
+				fn(entry);
+				return true;
+			}
+		}
+
+		// Visits all entries below node, returns false if the callback stopped the traversal
+		template<typename Fn>
+		static bool Walk(Node* node, Fn& fn)
+		{
+			if (!node) return true;
+			if (node->type == NodeType::Leaf) return Visit(fn, *static_cast<Entry*>(node));
+
+			Inner* inner = static_cast<Inner*>(node);
+			if (inner->terminal && !Visit(fn, *inner->terminal)) return false;
+
+			return WalkChildren(inner, 0, fn);
+		}
+
+		// Visits the subtrees of all children with a byte >= first
+		template<typename Fn>
+		static bool WalkChildren(Inner* inner, uint16_t first, Fn& fn)
+		{
+			switch (inner->type)
+			{
+			case NodeType::Node4:
+			{
+				Node4* node = static_cast<Node4*>(inner);
+				for (uint16_t i = LowerChild(node->keys, node->count, (uint8_t)first); i < node->count; i++)
+					if (!Walk(node->children[i], fn)) return false;
+				return true;
+			}
+			case NodeType::Node16:
+			{
+				Node16* node = static_cast<Node16*>(inner);
+				for (uint16_t i = LowerChild(node->keys, node->count, (uint8_t)first); i < node->count; i++)
+					if (!Walk(node->children[i], fn)) return false;
+				return true;
+			}
+			case NodeType::Node48:
+			{
+				Node48* node = static_cast<Node48*>(inner);
+				for (uint16_t byte = first; byte < 256; byte++)
+					if (node->index[byte] && !Walk(node->children[node->index[byte] - 1], fn)) return false;
+				return true;
+			}
+			case NodeType::Node256:
+			{
+				Node256* node = static_cast<Node256*>(inner);
+				for (uint16_t byte = first; byte < 256; byte++)
+					if (node->children[byte] && !Walk(node->children[byte], fn)) return false;
+				return true;
+			}
+			default:
+				return true;
+			}
+		}
+
+		// Visits entries below node with key >= key. All keys below node share key[0, depth).
+		template<typename Fn>
+		static bool WalkFrom(Node* node, const mRadixKey& key, uint32_t depth, Fn& fn)
+		{
+			if (!node) return true;
+			if (node->type == NodeType::Leaf)
+			{
+				Entry* entry = static_cast<Entry*>(node);
+				return Compare(entry->key(), key) < 0 ? true : Visit(fn, *entry);
+			}
+
+			Inner* inner = static_cast<Inner*>(node);
+			for (uint32_t i = 0; i < inner->prefixLength; i++)
+			{
+				if (depth + i == key.size()) return Walk(node, fn);	// Key ends inside the prefix, subtree is greater
+				if (inner->prefix[i] < key[depth + i]) return true;	// Subtree is less
+				if (inner->prefix[i] > key[depth + i]) return Walk(node, fn);
+			}
+			depth += inner->prefixLength;
+
+			if (depth == key.size()) return Walk(node, fn);
+
+			// The terminal is a strict prefix of the key, so it's skipped
+			uint8_t byte = key[depth];
+			Node** child = FindChild(inner, byte);
+			if (child && !WalkFrom(*child, key, depth + 1, fn)) return false;
+
+			return byte == 255 ? true : WalkChildren(inner, (uint16_t)byte + 1, fn);
+		}
+
+		static int Compare(const mRadixKey& lhs, const mRadixKey& rhs)
+		{
+			uint32_t length = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+			int result = memcmp(lhs.data(), rhs.data(), length);
+			if (result != 0) return result;
+
+			return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+		}
+
+	private: // Underlying Element Modifier Methods
+		template<typename... Args>
+		Entry* NewEntry(const mRadixKey& key, Args&&... args)
+		{
+			mSize++;
+			uint8_t* keyData = this->template Allocate<uint8_t>(key.size());
+			return Memory::Emplace<Entry>(this->template Allocate<Entry>(1), keyData, key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		Entry* Insert(Node** ref, const mRadixKey& key, uint32_t depth, Args&&... args)
+		{
+			Node* node = *ref;
+			if (!node)
+			{
+				Entry* entry = NewEntry(key, std::forward<Args>(args)...);
+				*ref = entry;
+				return entry;
+			}
+
+			if (node->type == NodeType::Leaf)
+			{
+				Entry* existing = static_cast<Entry*>(node);
+				if (Matches(existing, key)) return existing;
+
+				// Split the leaf into a Node4 holding the common part of both keys as its prefix
+				mRadixKey existingKey = existing->key();
+				uint32_t limit = key.size() < existingKey.size() ? key.size() : existingKey.size();
+				uint32_t common = depth;
+				while (common < limit && key[common] == existingKey[common])
+					common++;
+
+				Node4* split = NewInner<Node4>();
+				SetPrefix(split, key.data() + depth, common - depth);
+				*ref = split;
+
+				AddLeaf(split, existing, existingKey, common);
+				Entry* entry = NewEntry(key, std::forward<Args>(args)...);
+				AddLeaf(split, entry, key, common);
+				return entry;
+			}
+
+			Inner* inner = static_cast<Inner*>(node);
+			if (inner->prefixLength)
+			{
+				uint32_t match = PrefixMismatch(inner, key, depth);
+				if (match < inner->prefixLength)
+				{
+					// Split the compressed path at the first mismatch
+					Node4* split = NewInner<Node4>();
+					SetPrefix(split, inner->prefix, match);
+					*ref = split;
+
+					uint8_t byte = inner->prefix[match];
+					uint32_t oldLength = inner->prefixLength;
+					uint8_t* oldPrefix = inner->prefix;
+					inner->prefix = nullptr;
+					SetPrefix(inner, oldPrefix + match + 1, oldLength - match - 1);
+					this->template Deallocate<uint8_t>(oldPrefix, oldLength);
+					AddChild(split, byte, inner);
+
+					Entry* entry = NewEntry(key, std::forward<Args>(args)...);
+					AddLeaf(split, entry, key, depth + match);
+					return entry;
+				}
+
+				depth += inner->prefixLength;
+			}
+
+			if (depth == key.size())
+			{
+				if (!inner->terminal) inner->terminal = NewEntry(key, std::forward<Args>(args)...);
+				return inner->terminal;
+			}
+
+			Node** child = FindChild(inner, key[depth]);
+			if (child) return Insert(child, key, depth + 1, std::forward<Args>(args)...);
+
+			Entry* entry = NewEntry(key, std::forward<Args>(args)...);
+			*ref = AddChild(inner, key[depth], entry);
+			return entry;
+		}
+
+		// Places an entry below a freshly split node, as its terminal if the key ends at depth
+		void AddLeaf(Node4* node, Entry* entry, const mRadixKey& key, uint32_t depth)
+		{
+			if (key.size() == depth)
+				node->terminal = entry;
+			else
+				AddChild(node, key[depth], entry);
+		}
+
+		// Adds a child, growing the node to the next size if it is full. Returns the (possibly new) node.
+		Inner* AddChild(Inner* inner, uint8_t byte, Node* child)
+		{
+			switch (inner->type)
+			{
+			case NodeType::Node4:
+			{
+				Node4* node = static_cast<Node4*>(inner);
+				if (node->count < 4)
+				{
+					InsertSorted(node->keys, node->children, node->count, byte, child);
+					return node;
+				}
+
+				Node16* grown = NewInner<Node16>();
+				MoveHeader(grown, node);
+				memcpy(grown->keys, node->keys, 4);
+				memcpy(grown->children, node->children, 4 * sizeof(Node*));
+				FreeInner(node);
+				return AddChild(grown, byte, child);
+			}
+			case NodeType::Node16:
+			{
+				Node16* node = static_cast<Node16*>(inner);
+				if (node->count < 16)
+				{
+					InsertSorted(node->keys, node->children, node->count, byte, child);
+					return node;
+				}
+
+				Node48* grown = NewInner<Node48>();
+				MoveHeader(grown, node);
+				for (uint16_t i = 0; i < 16; i++)
+				{
+					grown->children[i] = node->children[i];
+					grown->index[node->keys[i]] = (uint8_t)(i + 1);
+				}
+				FreeInner(node);
+				return AddChild(grown, byte, child);
+			}
+			case NodeType::Node48:
+			{
+				Node48* node = static_cast<Node48*>(inner);
+				if (node->count < 48)
+				{
+					uint8_t slot = 0;
+					while (node->children[slot])
+						slot++;
+
+					node->children[slot] = child;
+					node->index[byte] = slot + 1;
+					node->count++;
+					return node;
+				}
+
+				Node256* grown = NewInner<Node256>();
+				MoveHeader(grown, node);
+				for (uint16_t i = 0; i < 256; i++)
+					if (node->index[i]) grown->children[i] = node->children[node->index[i] - 1];
+				FreeInner(node);
+				return AddChild(grown, byte, child);
+			}
+			case NodeType::Node256:
+			{
+				Node256* node = static_cast<Node256*>(inner);
+				node->children[byte] = child;
+				node->count++;
+				return node;
+			}
+			default:
+				return inner;
+			}
+		}
+
+		static void InsertSorted(uint8_t* keys, Node** children, uint16_t& count, uint8_t byte, Node* child)
+		{
+			uint16_t pos = LowerChild(keys, count, byte);
+			memmove(keys + pos + 1, keys + pos, count - pos);
+			memmove(children + pos + 1, children + pos, (count - pos) * sizeof(Node*));
+			keys[pos] = byte;
+			children[pos] = child;
+			count++;
+		}
+
+		void RemoveChild(Inner* inner, uint8_t byte)
+		{
+			switch (inner->type)
+			{
+			case NodeType::Node4:
+			case NodeType::Node16:
+			{
+				uint8_t* keys = inner->type == NodeType::Node4 ? static_cast<Node4*>(inner)->keys : static_cast<Node16*>(inner)->keys;
+				Node** children = inner->type == NodeType::Node4 ? static_cast<Node4*>(inner)->children : static_cast<Node16*>(inner)->children;
+				uint16_t pos = LowerChild(keys, inner->count, byte);
+				memmove(keys + pos, keys + pos + 1, inner->count - pos - 1);
+				memmove(children + pos, children + pos + 1, (inner->count - pos - 1) * sizeof(Node*));
+				break;
+			}
+			case NodeType::Node48:
+			{
+				Node48* node = static_cast<Node48*>(inner);
+				node->children[node->index[byte] - 1] = nullptr;
+				node->index[byte] = 0;
+				break;
+			}
+			case NodeType::Node256:
+				static_cast<Node256*>(inner)->children[byte] = nullptr;
+				break;
+			default:
+				break;
+			}
+
+			inner->count--;
+		}
+
+		bool Erase(Node** ref, const mRadixKey& key, uint32_t depth)
+		{
+			Node* node = *ref;
+			if (!node) return false;
+
+			if (node->type == NodeType::Leaf)
+			{
+				Entry* entry = static_cast<Entry*>(node);
+				if (!Matches(entry, key)) return false;
+
+				FreeNode(entry);
+				*ref = nullptr;
+				return true;
+			}
+
+			Inner* inner = static_cast<Inner*>(node);
+			if (PrefixMismatch(inner, key, depth) != inner->prefixLength) return false;
+			depth += inner->prefixLength;
+
+			if (depth == key.size())
+			{
+				if (!inner->terminal) return false;
+
+				FreeNode(inner->terminal);
+				inner->terminal = nullptr;
+			}
+			else
+			{
+				uint8_t byte = key[depth];
+				Node** child = FindChild(inner, byte);
+				if (!child || !Erase(child, key, depth + 1)) return false;
+
+				if (!*child) RemoveChild(inner, byte);
+			}
+
+			// An inner node without children collapses to its terminal, which holds its full key
+			if (inner->count == 0)
+			{
+				*ref = inner->terminal;
+				FreeInner(inner);
+			}
+
+			return true;
+		}
+
+	private: // Node Management Methods
+		template<typename N>
+		N* NewInner()
+		{
+			return Memory::Emplace<N>(this->template Allocate<N>(1));
+		}
+
+		void SetPrefix(Inner* inner, const uint8_t* prefix, uint32_t length)
+		{
+			inner->prefixLength = length;
+			if (length == 0) return;
+
+			inner->prefix = this->template Allocate<uint8_t>(length);
+			memcpy(inner->prefix, prefix, length);
+		}
+
+		static void MoveHeader(Inner* to, Inner* from)
+		{
+			to->count = from->count;
+			to->prefixLength = from->prefixLength;
+			to->prefix = from->prefix;
+			to->terminal = from->terminal;
+
+			from->prefixLength = 0;
+			from->prefix = nullptr;
+			from->terminal = nullptr;
+		}
+
+		// Frees only the node itself, not its children or terminal
+		void FreeInner(Inner* inner)
+		{
+			if (inner->prefix) this->template Deallocate<uint8_t>(inner->prefix, inner->prefixLength);
+
+			switch (inner->type)
+			{
+			case NodeType::Node4:	this->template Deallocate<Node4>(static_cast<Node4*>(inner), 1); break;
+			case NodeType::Node16:	this->template Deallocate<Node16>(static_cast<Node16*>(inner), 1); break;
+			case NodeType::Node48:	this->template Deallocate<Node48>(static_cast<Node48*>(inner), 1); break;
+			case NodeType::Node256:	this->template Deallocate<Node256>(static_cast<Node256*>(inner), 1); break;
+			default: break;
+			}
+		}
+
+		void FreeNode(Node* node)
+		{
+			if (!node) return;
+
+			if (node->type == NodeType::Leaf)
+			{
+				Entry* entry = static_cast<Entry*>(node);
+				this->template Deallocate<uint8_t>(entry->mKey, entry->mLength);
+				entry->~Entry();
+				this->template Deallocate<Entry>(entry, 1);
+				return;
+			}
+
+			Inner* inner = static_cast<Inner*>(node);
+			FreeNode(inner->terminal);
+			inner->terminal = nullptr;
+			FreeChildren(inner);
+			FreeInner(inner);
+		}
+
+		void FreeChildren(Inner* inner)
+		{
+			switch (inner->type)
+			{
+			case NodeType::Node4:
+				for (uint16_t i = 0; i < inner->count; i++)
+					FreeNode(static_cast<Node4*>(inner)->children[i]);
+				break;
+			case NodeType::Node16:
+				for (uint16_t i = 0; i < inner->count; i++)
+					FreeNode(static_cast<Node16*>(inner)->children[i]);
+				break;
+			case NodeType::Node48:
+				for (uint16_t i = 0; i < 48; i++)
+					FreeNode(static_cast<Node48*>(inner)->children[i]);
+				break;
+			case NodeType::Node256:
+				for (uint16_t i = 0; i < 256; i++)
+					FreeNode(static_cast<Node256*>(inner)->children[i]);
+				break;
+			default:
+				break;
+			}
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,542 @@
+#pragma once
+
+#include "mCore.h"
+#include "mUtils.h"
+
+#if defined(M_SIMD_SSE2)
+#include <immintrin.h>
+
+// AVX2 kernels are compiled alongside the SSE2 ones and picked at runtime
+#if defined(__GNUC__) || defined(__clang__)
+	#define M_SIMD_AVX2_DISPATCH
+	#define M_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#elif defined(_MSC_VER)
+	#define M_SIMD_AVX2_DISPATCH
+	#define M_TARGET_AVX2
+#endif
+#endif
+
+namespace mContainers {
+
+	// Linear scans over contiguous elements. Arithmetic, enum and pointer elements are compared 16 or 32 bytes
+	// at a time with SSE2, or AVX2 when the CPU has it, anything else goes through the scalar loops below.
+	// Floats compare as floats, so -0 matches 0 and NaN matches nothing, the same as operator==.
+	namespace Simd {
+
+		template<typename T>
+		constexpr bool Searchable = (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+			&& !std::is_same_v<T, long double> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+		template<typename T>
+		constexpr bool Ordered = Searchable<T> && std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+		// Values find_any compares each block against at once, longer lists are searched in groups
+		constexpr uint64_t AnyGroupSize = 8;
+
+		namespace Scalar {
+
+			template<typename T>
+			uint64_t Find(const T* data, uint64_t count, const T& value)
+			{
+				for (uint64_t i = 0; i < count; i++)
+					if (data[i] == value) return i;
+
+				return count;
+			}
+
+			template<typename T>
+			uint64_t Count(const T* data, uint64_t count, const T& value)
+			{
+				uint64_t matches = 0;
+				for (uint64_t i = 0; i < count; i++)
+					matches += data[i] == value;
+
+				return matches;
+			}
+
+			template<typename T>
+			uint64_t FindAny(const T* data, uint64_t count, const T* values, uint64_t valueCount)
+			{
+				for (uint64_t i = 0; i < count; i++)
+					for (uint64_t v = 0; v < valueCount; v++)
+						if (data[i] == values[v]) return i;
+
+				return count;
+			}
+
+			// Keeps best unless value is strictly better, so NaNs are skipped unless data starts with one
+			template<typename T, bool Greatest>
+			inline const T& Better(const T& value, const T& best)
+			{
+				if constexpr (Greatest) return best < value ? value : best;
+				else return value < best ? value : best;
+			}
+
+			template<typename T, bool Greatest>
+			T Extreme(const T* data, uint64_t count)
+			{
+				T best = data[0];
+				for (uint64_t i = 1; i < count; i++)
+					best = Better<T, Greatest>(data[i], best);
+
+				return best;
+			}
+
+		}
+
+		template<uint64_t Size> struct Bits;
+		template<> struct Bits<1> { using Type = char; };
+		template<> struct Bits<2> { using Type = short; };
+		template<> struct Bits<4> { using Type = int; };
+		template<> struct Bits<8> { using Type = long long; };
+
+		// Integer with the same bits as value, for broadcasting
+		template<typename T>
+		inline typename Bits<sizeof(T)>::Type AsBits(T value)
+		{
+			typename Bits<sizeof(T)>::Type bits;
+			memcpy(&bits, &value, sizeof(T));
+			return bits;
+		}
+
+		// Value with only the sign bit of T set, unsigned lanes are biased by it to compare as signed
+		template<typename T>
+		inline typename Bits<sizeof(T)>::Type SignBit()
+		{
+			return (typename Bits<sizeof(T)>::Type)(1ull << (sizeof(T) * 8 - 1));
+		}
+
+#if defined(M_SIMD_SSE2)
+		namespace Sse2 {
+
+			using Vec = __m128i;
+			constexpr uint64_t Width = sizeof(Vec);
+
+			inline Vec Load(const void* data) { return _mm_loadu_si128((const Vec*)data); }
+			inline uint32_t Mask(Vec v) { return (uint32_t)_mm_movemask_epi8(v); }
+
+			template<typename T>
+			inline Vec Splat(T value)
+			{
+				if constexpr (std::is_same_v<T, float>) return _mm_castps_si128(_mm_set1_ps(value));
+				else if constexpr (std::is_same_v<T, double>) return _mm_castpd_si128(_mm_set1_pd(value));
+				else if constexpr (sizeof(T) == 1) return _mm_set1_epi8(AsBits(value));
+				else if constexpr (sizeof(T) == 2) return _mm_set1_epi16(AsBits(value));
+				else if constexpr (sizeof(T) == 4) return _mm_set1_epi32(AsBits(value));
+				else return _mm_set1_epi64x(AsBits(value));
+			}
+
+			// All ones in the lanes where a == b
+			template<typename T>
+			inline Vec Equal(Vec a, Vec b)
+			{
+				if constexpr (std::is_same_v<T, float>) return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+				else if constexpr (std::is_same_v<T, double>) return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+				else if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(a, b);
+				else
+				{
+					// No 64 bit compare before SSE4.1, both 32 bit halves have to match
+					Vec halves = _mm_cmpeq_epi32(a, b);
+					return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+				}
+			}
+
+			// SSE2 has no 64 bit integer ordering, those arrays take the scalar loop
+			template<typename T>
+			constexpr bool HasExtreme = Ordered<T> && (std::is_floating_point_v<T> || sizeof(T) < 8);
+
+			template<typename T, bool Greatest>
+			inline Vec Pick(Vec value, Vec best)
+			{
+				if constexpr (std::is_same_v<T, float>)
+				{
+					__m128 v = _mm_castsi128_ps(value), b = _mm_castsi128_ps(best);
+					return _mm_castps_si128(Greatest ? _mm_max_ps(v, b) : _mm_min_ps(v, b));
+				}
+				else if constexpr (std::is_same_v<T, double>)
+				{
+					__m128d v = _mm_castsi128_pd(value), b = _mm_castsi128_pd(best);
+					return _mm_castpd_si128(Greatest ? _mm_max_pd(v, b) : _mm_min_pd(v, b));
+				}
+				else
+				{
+					Vec a = value, b = best;
+					if constexpr (std::is_unsigned_v<T>)
+					{
+						a = _mm_xor_si128(a, Splat(SignBit<T>()));
+						b = _mm_xor_si128(b, Splat(SignBit<T>()));
+					}
+
+					Vec greater;
+					if constexpr (sizeof(T) == 1) greater = _mm_cmpgt_epi8(a, b);
+					else if constexpr (sizeof(T) == 2) greater = _mm_cmpgt_epi16(a, b);
+					else greater = _mm_cmpgt_epi32(a, b);
+
+					if constexpr (Greatest) return _mm_or_si128(_mm_and_si128(greater, value), _mm_andnot_si128(greater, best));
+					else return _mm_or_si128(_mm_and_si128(greater, best), _mm_andnot_si128(greater, value));
+				}
+			}
+
+			template<typename T>
+			inline uint64_t Find(const T* data, uint64_t count, T value)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				const Vec needle = Splat(value);
+
+				// Four blocks per test while nothing matches, the single block loop then finds the lane
+				uint64_t i = 0;
+				for (; i + 4 * Lanes <= count; i += 4 * Lanes)
+				{
+					Vec hits = _mm_or_si128(
+						_mm_or_si128(Equal<T>(Load(data + i), needle), Equal<T>(Load(data + i + Lanes), needle)),
+						_mm_or_si128(Equal<T>(Load(data + i + 2 * Lanes), needle), Equal<T>(Load(data + i + 3 * Lanes), needle)));
+					if (Mask(hits)) break;
+				}
+
+				for (; i + Lanes <= count; i += Lanes)
+				{
+					uint32_t mask = Mask(Equal<T>(Load(data + i), needle));
+					if (mask) return i + Utils::CountTrailingZeros(mask) / sizeof(T);
+				}
+
+				return i + Scalar::Find(data + i, count - i, value);
+			}
+
+			template<typename T>
+			inline uint64_t Count(const T* data, uint64_t count, T value)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				const Vec needle = Splat(value);
+
+				uint64_t matchingBytes = 0;
+				uint64_t i = 0;
+				for (; i + Lanes <= count; i += Lanes)
+					matchingBytes += Utils::PopCount(Mask(Equal<T>(Load(data + i), needle)));
+
+				return matchingBytes / sizeof(T) + Scalar::Count(data + i, count - i, value);
+			}
+
+			template<typename T>
+			inline uint64_t FindAny(const T* data, uint64_t count, const T* values, uint64_t valueCount)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				Vec needles[AnyGroupSize];
+				for (uint64_t v = 0; v < valueCount; v++)
+					needles[v] = Splat(values[v]);
+
+				uint64_t i = 0;
+				for (; i + Lanes <= count; i += Lanes)
+				{
+					Vec block = Load(data + i);
+					Vec hits = Equal<T>(block, needles[0]);
+					for (uint64_t v = 1; v < valueCount; v++)
+						hits = _mm_or_si128(hits, Equal<T>(block, needles[v]));
+
+					uint32_t mask = Mask(hits);
+					if (mask) return i + Utils::CountTrailingZeros(mask) / sizeof(T);
+				}
+
+				return i + Scalar::FindAny(data + i, count - i, values, valueCount);
+			}
+
+			template<typename T, bool Greatest>
+			inline T Extreme(const T* data, uint64_t count)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				Vec best0 = Splat(data[0]), best1 = best0;
+
+				uint64_t i = 0;
+				for (; i + 2 * Lanes <= count; i += 2 * Lanes)
+				{
+					best0 = Pick<T, Greatest>(Load(data + i), best0);
+					best1 = Pick<T, Greatest>(Load(data + i + Lanes), best1);
+				}
+
+				T lanes[2 * Lanes];
+				_mm_storeu_si128((Vec*)lanes, best0);
+				_mm_storeu_si128((Vec*)(lanes + Lanes), best1);
+
+				T best = data[0];
+				for (uint64_t j = 0; j < 2 * Lanes; j++)
+					best = Scalar::Better<T, Greatest>(lanes[j], best);
+				for (; i < count; i++)
+					best = Scalar::Better<T, Greatest>(data[i], best);
+
+				return best;
+			}
+
+		}
+#endif
+
+#if defined(M_SIMD_AVX2_DISPATCH)
+		namespace Avx2 {
+
+			using Vec = __m256i;
+			constexpr uint64_t Width = sizeof(Vec);
+
+			M_TARGET_AVX2 inline Vec Load(const void* data) { return _mm256_loadu_si256((const Vec*)data); }
+			M_TARGET_AVX2 inline uint32_t Mask(Vec v) { return (uint32_t)_mm256_movemask_epi8(v); }
+
+			template<typename T>
+			M_TARGET_AVX2 inline Vec Splat(T value)
+			{
+				if constexpr (std::is_same_v<T, float>) return _mm256_castps_si256(_mm256_set1_ps(value));
+				else if constexpr (std::is_same_v<T, double>) return _mm256_castpd_si256(_mm256_set1_pd(value));
+				else if constexpr (sizeof(T) == 1) return _mm256_set1_epi8(AsBits(value));
+				else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(AsBits(value));
+				else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(AsBits(value));
+				else return _mm256_set1_epi64x(AsBits(value));
+			}
+
+			template<typename T>
+			M_TARGET_AVX2 inline Vec Equal(Vec a, Vec b)
+			{
+				if constexpr (std::is_same_v<T, float>) return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+				else if constexpr (std::is_same_v<T, double>) return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+				else if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+				else return _mm256_cmpeq_epi64(a, b);
+			}
+
+			template<typename T>
+			constexpr bool HasExtreme = Ordered<T>;
+
+			template<typename T, bool Greatest>
+			M_TARGET_AVX2 inline Vec Pick(Vec value, Vec best)
+			{
+				if constexpr (std::is_same_v<T, float>)
+				{
+					__m256 v = _mm256_castsi256_ps(value), b = _mm256_castsi256_ps(best);
+					return _mm256_castps_si256(Greatest ? _mm256_max_ps(v, b) : _mm256_min_ps(v, b));
+				}
+				else if constexpr (std::is_same_v<T, double>)
+				{
+					__m256d v = _mm256_castsi256_pd(value), b = _mm256_castsi256_pd(best);
+					return _mm256_castpd_si256(Greatest ? _mm256_max_pd(v, b) : _mm256_min_pd(v, b));
+				}
+				else if constexpr (sizeof(T) == 8)
+				{
+					// Only a signed 64 bit compare, unsigned lanes are biased first
+					Vec a = value, b = best;
+					if constexpr (std::is_unsigned_v<T>)
+					{
+						a = _mm256_xor_si256(a, Splat(SignBit<T>()));
+						b = _mm256_xor_si256(b, Splat(SignBit<T>()));
+					}
+
+					Vec greater = _mm256_cmpgt_epi64(a, b);
+					return Greatest ? _mm256_blendv_epi8(best, value, greater) : _mm256_blendv_epi8(value, best, greater);
+				}
+				else if constexpr (std::is_signed_v<T>)
+				{
+					if constexpr (sizeof(T) == 1) return Greatest ? _mm256_max_epi8(value, best) : _mm256_min_epi8(value, best);
+					else if constexpr (sizeof(T) == 2) return Greatest ? _mm256_max_epi16(value, best) : _mm256_min_epi16(value, best);
+					else return Greatest ? _mm256_max_epi32(value, best) : _mm256_min_epi32(value, best);
+				}
+				else
+				{
+					if constexpr (sizeof(T) == 1) return Greatest ? _mm256_max_epu8(value, best) : _mm256_min_epu8(value, best);
+					else if constexpr (sizeof(T) == 2) return Greatest ? _mm256_max_epu16(value, best) : _mm256_min_epu16(value, best);
+					else return Greatest ? _mm256_max_epu32(value, best) : _mm256_min_epu32(value, best);
+				}
+			}
+
+			template<typename T>
+			M_TARGET_AVX2 inline uint64_t Find(const T* data, uint64_t count, T value)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				const Vec needle = Splat(value);
+
+				uint64_t i = 0;
+				for (; i + 4 * Lanes <= count; i += 4 * Lanes)
+				{
+					Vec hits = _mm256_or_si256(
+						_mm256_or_si256(Equal<T>(Load(data + i), needle), Equal<T>(Load(data + i + Lanes), needle)),
+						_mm256_or_si256(Equal<T>(Load(data + i + 2 * Lanes), needle), Equal<T>(Load(data + i + 3 * Lanes), needle)));
+					if (Mask(hits)) break;
+				}
+
+				for (; i + Lanes <= count; i += Lanes)
+				{
+					uint32_t mask = Mask(Equal<T>(Load(data + i), needle));
+					if (mask) return i + Utils::CountTrailingZeros(mask) / sizeof(T);
+				}
+
+				return i + Scalar::Find(data + i, count - i, value);
+			}
+
+			template<typename T>
+			M_TARGET_AVX2 inline uint64_t Count(const T* data, uint64_t count, T value)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				const Vec needle = Splat(value);
+
+				uint64_t matchingBytes = 0;
+				uint64_t i = 0;
+				for (; i + Lanes <= count; i += Lanes)
+					matchingBytes += Utils::PopCount(Mask(Equal<T>(Load(data + i), needle)));
+
+				return matchingBytes / sizeof(T) + Scalar::Count(data + i, count - i, value);
+			}
+
+			template<typename T>
+			M_TARGET_AVX2 inline uint64_t FindAny(const T* data, uint64_t count, const T* values, uint64_t valueCount)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				Vec needles[AnyGroupSize];
+				for (uint64_t v = 0; v < valueCount; v++)
+					needles[v] = Splat(values[v]);
+
+				uint64_t i = 0;
+				for (; i + Lanes <= count; i += Lanes)
+				{
+					Vec block = Load(data + i);
+					Vec hits = Equal<T>(block, needles[0]);
+					for (uint64_t v = 1; v < valueCount; v++)
+						hits = _mm256_or_si256(hits, Equal<T>(block, needles[v]));
+
+					uint32_t mask = Mask(hits);
+					if (mask) return i + Utils::CountTrailingZeros(mask) / sizeof(T);
+				}
+
+				return i + Scalar::FindAny(data + i, count - i, values, valueCount);
+			}
+
+			template<typename T, bool Greatest>
+			M_TARGET_AVX2 inline T Extreme(const T* data, uint64_t count)
+			{
+				constexpr uint64_t Lanes = Width / sizeof(T);
+				Vec best0 = Splat(data[0]), best1 = best0;
+
+				uint64_t i = 0;
+				for (; i + 2 * Lanes <= count; i += 2 * Lanes)
+				{
+					best0 = Pick<T, Greatest>(Load(data + i), best0);
+					best1 = Pick<T, Greatest>(Load(data + i + Lanes), best1);
+				}
+
+				T lanes[2 * Lanes];
+				_mm256_storeu_si256((Vec*)lanes, best0);
+				_mm256_storeu_si256((Vec*)(lanes + Lanes), best1);
+
+				T best = data[0];
+				for (uint64_t j = 0; j < 2 * Lanes; j++)
+					best = Scalar::Better<T, Greatest>(lanes[j], best);
+				for (; i < count; i++)
+					best = Scalar::Better<T, Greatest>(data[i], best);
+
+				return best;
+			}
+
+		}
+
+		// Checked once, the kernels are chosen per call
+		inline bool HasAvx2()
+		{
+			static const bool supported = []()
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				int info[4];
+				__cpuid(info, 1);
+				bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+				__cpuidex(info, 7, 0);
+				return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2") != 0;
+#endif
+			}();
+
+			return supported;
+		}
+#endif
+
+		// Index of the first element equal to value, count if there is none
+		template<typename T>
+		uint64_t Find(const T* data, uint64_t count, const T& value)
+		{
+#if defined(M_SIMD_SSE2)
+			if constexpr (Searchable<T>)
+			{
+#if defined(M_SIMD_AVX2_DISPATCH)
+				if (HasAvx2()) return Avx2::Find(data, count, value);
+#endif
+				return Sse2::Find(data, count, value);
+			}
+#endif
+			return Scalar::Find(data, count, value);
+		}
+
+		// Number of elements equal to value
+		template<typename T>
+		uint64_t Count(const T* data, uint64_t count, const T& value)
+		{
+#if defined(M_SIMD_SSE2)
+			if constexpr (Searchable<T>)
+			{
+#if defined(M_SIMD_AVX2_DISPATCH)
+				if (HasAvx2()) return Avx2::Count(data, count, value);
+#endif
+				return Sse2::Count(data, count, value);
+			}
+#endif
+			return Scalar::Count(data, count, value);
+		}
+
+		// Index of the first element equal to any of values, count if there is none
+		template<typename T>
+		uint64_t FindAny(const T* data, uint64_t count, const T* values, uint64_t valueCount)
+		{
+#if defined(M_SIMD_SSE2)
+			if constexpr (Searchable<T>)
+			{
+				// Later groups only search ahead of the first match found so far
+				for (uint64_t v = 0; v < valueCount; v += AnyGroupSize)
+				{
+					uint64_t group = valueCount - v < AnyGroupSize ? valueCount - v : AnyGroupSize;
+#if defined(M_SIMD_AVX2_DISPATCH)
+					if (HasAvx2())
+					{
+						count = Avx2::FindAny(data, count, values + v, group);
+						continue;
+					}
+#endif
+					count = Sse2::FindAny(data, count, values + v, group);
+				}
+
+				return count;
+			}
+#endif
+			return Scalar::FindAny(data, count, values, valueCount);
+		}
+
+		template<typename T, bool Greatest>
+		T Extreme(const T* data, uint64_t count)
+		{
+			mAssert(count > 0, "No elements to compare!");
+
+#if defined(M_SIMD_AVX2_DISPATCH)
+			if constexpr (Avx2::HasExtreme<T>)
+			{
+				if (HasAvx2()) return Avx2::Extreme<T, Greatest>(data, count);
+			}
+#endif
+#if defined(M_SIMD_SSE2)
+			if constexpr (Sse2::HasExtreme<T>) return Sse2::Extreme<T, Greatest>(data, count);
+#endif
+			return Scalar::Extreme<T, Greatest>(data, count);
+		}
+
+		// Smallest and largest element by operator<, count must be non-zero. NaNs are skipped unless data
+		// starts with one.
+		template<typename T>
+		T Min(const T* data, uint64_t count) { return Extreme<T, false>(data, count); }
+		template<typename T>
+		T Max(const T* data, uint64_t count) { return Extreme<T, true>(data, count); }
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mSpan.h"
+
+namespace mContainers {
+
+	// Stable reference to an element of an mSlotMap. Stays valid until that element is erased, after which
+	// the generation no longer matches and lookups return nothing, even once the slot is reused.
+	struct mSlotHandle
+	{
+		uint32_t index;
+		uint32_t generation;
+
+		mSlotHandle() : index((uint32_t)-1), generation(0) {}
+		mSlotHandle(uint32_t _index, uint32_t _generation)
+			: index(_index), generation(_generation) {}
+
+		bool operator==(const mSlotHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const mSlotHandle& other) const { return !(*this == other); }
+	};
+
+	// Values are kept packed for iteration, handles go through one indirection (slot -> dense index) instead
+	// of a hash lookup. Erase moves the last value into the hole and puts the slot on a free list, so insert
+	// and erase are O(1). T must be default constructable. The allocator is shared by the slots and values.
+	template<typename T, typename Allocator = Memory>
+	class mSlotMap
+	{
+	private:
+		static constexpr uint32_t NoSlot = (uint32_t)-1;
+
+		struct Slot
+		{
+			uint32_t index;			// Dense index while in use, next free slot otherwise
+			uint32_t generation;
+
+			Slot() : index(NoSlot), generation(0) {}
+			Slot(uint32_t _index, uint32_t _generation)
+				: index(_index), generation(_generation) {}
+		};
+
+	public:
+		using ValType = T;
+
+	private:
+		mDynArray<Slot, Allocator> mSlots;
+		mDynArray<T, Allocator> mValues;
+		mDynArray<uint32_t, Allocator> mOwners;	// Slot of each dense value
+		uint32_t mFreeHead;
+
+	public:
+		mSlotMap(const Allocator& allocator = Allocator())
+			: mSlots(allocator), mValues(allocator), mOwners(allocator), mFreeHead(NoSlot) {}
+
+		const Allocator& allocator() const { return mValues.allocator(); }
+
+	public: // Access Operators
+		T* get(mSlotHandle handle)
+		{
+			if (!contains(handle)) return nullptr;
+
+			return &mValues[mSlots[handle.index].index];
+		}
+		const T* get(mSlotHandle handle) const
+		{
+			if (!contains(handle)) return nullptr;
+
+			return &mValues[mSlots[handle.index].index];
+		}
+
+		T& operator[](mSlotHandle handle)
+		{
+			mAssert(contains(handle), "Stale or invalid handle!");
+
+			return mValues[mSlots[handle.index].index];
+		}
+		const T& operator[](mSlotHandle handle) const
+		{
+			mAssert(contains(handle), "Stale or invalid handle!");
+
+			return mValues[mSlots[handle.index].index];
+		}
+
+		bool contains(mSlotHandle handle) const
+		{
+			return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation;
+		}
+
+		// Handle of the value at a dense position, e.g. while iterating
+		mSlotHandle handleAt(uint64_t denseIndex) const
+		{
+			uint32_t slot = mOwners[denseIndex];
+			return mSlotHandle(slot, mSlots[slot].generation);
+		}
+
+	public: // Iterator Methods
+		auto begin() { return mValues.begin(); }
+		const auto begin() const { return mValues.begin(); }
+		auto end() { return mValues.end(); }
+		const auto end() const { return mValues.end(); }
+
+		mSpan<T> values() { return mSpan<T>(mValues.data(), mValues.size()); }
+		mSpan<const T> values() const { return mSpan<const T>(mValues.data(), mValues.size()); }
+
+	public: // Element Modifiers
+		mSlotHandle insert(const T& value)
+		{
+			mValues.emplace_back(value);
+			return Claim();
+		}
+
+		template<typename... Args>
+		mSlotHandle emplace(Args&&... args)
+		{
+			mValues.emplace_back(std::forward<Args>(args)...);
+			return Claim();
+		}
+
+		// Returns false for stale handles
+		bool erase(mSlotHandle handle)
+		{
+			if (!contains(handle)) return false;
+
+			Slot& slot = mSlots[handle.index];
+			uint32_t dense = slot.index;
+			uint32_t last = (uint32_t)mValues.size() - 1;
+			if (dense != last)
+			{
+				mValues[dense] = std::move(mValues[last]);
+				mOwners[dense] = mOwners[last];
+				mSlots[mOwners[dense]].index = dense;
+			}
+			mValues.pop_back();
+			mOwners.pop_back();
+
+			// Bumping the generation invalidates every outstanding handle to the slot
+			slot.generation++;
+			slot.index = mFreeHead;
+			mFreeHead = handle.index;
+			return true;
+		}
+
+		void clear()
+		{
+			for (uint64_t i = 0; i < mOwners.size(); i++)
+			{
+				Slot& slot = mSlots[mOwners[i]];
+				slot.generation++;
+				slot.index = mFreeHead;
+				mFreeHead = mOwners[i];
+			}
+
+			mValues.clear();
+			mOwners.clear();
+		}
+
+		void reserve(uint64_t count)
+		{
+			mSlots.reserve(count);
+			mValues.reserve(count);
+			mOwners.reserve(count);
+		}
+
+	public:
+		uint64_t size() const { return mValues.size(); }
+		bool empty() const { return mValues.size() == 0; }
+
+	private:
+		// Links the value just appended to a free slot, or a new one
+		mSlotHandle Claim()
+		{
+			uint32_t dense = (uint32_t)mValues.size() - 1;
+			uint32_t index = mFreeHead;
+			if (index != NoSlot)
+			{
+				mFreeHead = mSlots[index].index;
+				mSlots[index].index = dense;
+			}
+			else
+			{
+				index = (uint32_t)mSlots.size();
+				mSlots.emplace_back(dense, 0);
+			}
+
+			mOwners.emplace_back(index);
+			return mSlotHandle(index, mSlots[index].generation);
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+namespace mContainers {
+
+	// mDynArray with room for N elements inside the object. Nothing is allocated until the N+1th element,
+	// then the elements move to the heap and stay there (clear keeps the heap buffer). Pointers and
+	// iterators are invalidated by growth and, while inline, by moving the array itself.
+	template<typename T, uint64_t N, typename Allocator = Memory>
+	class mSmallArray : private mAllocatorStorage<Allocator>
+	{
+	public:
+		using VecType = mSmallArray<T, N, Allocator>;
+		using Iterator = mDynIterator<VecType>;
+		using ValType = T;
+		using AllocatorType = Allocator;
+
+	private:
+		using Storage = mAllocatorStorage<Allocator>;
+
+		mStaticAssert(N > 0, "Inline capacity must be at least one element!")
+
+		static constexpr bool Relocatable = mIsTriviallyRelocatable<T>::value;
+
+		alignas(T) unsigned char mInline[N * sizeof(T)];
+		T* mData;	// Points at mInline until the first spill
+
+		uint64_t mSize;
+		uint64_t mCapacity;
+
+	public:
+		mSmallArray()
+			: mData(Inline()), mSize(0), mCapacity(N) {}
+
+		explicit mSmallArray(const Allocator& allocator)
+			: Storage(allocator), mData(Inline()), mSize(0), mCapacity(N) {}
+
+		mSmallArray(uint64_t count, const Allocator& allocator = Allocator())
+			: Storage(allocator), mData(Inline()), mSize(0), mCapacity(N)
+		{
+			resize(count);
+		}
+
+		mSmallArray(uint64_t count, const T& val, const Allocator& allocator = Allocator())
+			: Storage(allocator), mData(Inline()), mSize(0), mCapacity(N)
+		{
+			resize(count, val);
+		}
+
+		mSmallArray(const mSmallArray& other)
+			: Storage(other.allocator()), mData(Inline()), mSize(0), mCapacity(N)
+		{
+			reserve(other.mSize);
+			for (uint64_t i = 0; i < other.mSize; i++)
+				Memory::Emplace<T>(&mData[i], other.mData[i]);
+			mSize = other.mSize;
+		}
+
+		mSmallArray(mSmallArray&& other)
+			: Storage(other.allocator()), mData(Inline()), mSize(0), mCapacity(N)
+		{
+			MoveFrom(other);
+		}
+
+		~mSmallArray()
+		{
+			clear();
+			if (!isInline()) this->template Deallocate<T>(mData, mCapacity);
+		}
+
+		VecType& operator=(const mSmallArray& other)
+		{
+			if (this == &other) return *this;
+
+			clear();
+			reserve(other.mSize);
+			for (uint64_t i = 0; i < other.mSize; i++)
+				Memory::Emplace<T>(&mData[i], other.mData[i]);
+			mSize = other.mSize;
+
+			return *this;
+		}
+
+		VecType& operator=(mSmallArray&& other)
+		{
+			if (this == &other) return *this;
+
+			clear();
+			if (!isInline()) this->template Deallocate<T>(mData, mCapacity);
+			mData = Inline();
+			mCapacity = N;
+
+			allocator() = other.allocator();
+			MoveFrom(other);
+			return *this;
+		}
+
+	public: // Access Operators
+		T& operator[](uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return mData[index];
+		}
+		const T& operator[](uint64_t index) const
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return mData[index];
+		}
+
+		T* data() { return mData; }
+		const T* data() const { return mData; }
+
+		// O(n) linear search
+		Iterator find(const T& value)
+		{
+			Iterator it = begin();
+			for (; it != end(); ++it)
+				if (*it == value) return it;
+
+			return it;
+		}
+
+	public: // Element Modifiers
+		void push_back(const T& value)
+		{
+			if (mSize >= mCapacity)
+			{
+				T copy(value); // value may live in the buffer being replaced
+				ReAlloc(2 * mCapacity);
+				Memory::Emplace<T>(&mData[mSize++], std::move(copy));
+				return;
+			}
+
+			Memory::Emplace<T>(&mData[mSize++], value);
+		}
+		void push_back(T&& value)
+		{
+			if (mSize >= mCapacity)
+				ReAlloc(2 * mCapacity);
+
+			Memory::Emplace<T>(&mData[mSize++], std::move(value));
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if (mSize >= mCapacity)
+				ReAlloc(2 * mCapacity);
+
+			Memory::Emplace<T>(&mData[mSize], std::forward<Args>(args)...);
+			return mData[mSize++];
+		}
+
+		void pop_back()
+		{
+			mAssert(mSize > 0, "Pop from an empty array!");
+
+			mData[--mSize].~T();
+		}
+
+		// Keeps the order of the remaining elements
+		void erase(const Iterator& it)
+		{
+			erase(it, it + 1);
+		}
+
+		// Removes [rangeBegin, rangeEnd)
+		void erase(const Iterator& rangeBegin, const Iterator& rangeEnd)
+		{
+			uint64_t first = Iterator(rangeBegin) - begin();
+			uint64_t last = Iterator(rangeEnd) - begin();
+			mAssert(first <= last && last <= mSize, "Erase range out of bounds!");
+			if (first == last) return;
+
+			uint64_t to = first;
+			for (uint64_t from = last; from < mSize; from++, to++)
+				mData[to] = std::move(mData[from]);
+			for (uint64_t i = to; i < mSize; i++)
+				mData[i].~T();
+
+			mSize = to;
+		}
+
+		// O(1) removal that moves the last element into the hole
+		void swap_remove(uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			if (index != mSize - 1) mData[index] = std::move(mData[mSize - 1]);
+			mData[--mSize].~T();
+		}
+
+		// Removes every element matching pred in one stable pass, returns how many were removed
+		template<typename Pred>
+		uint64_t erase_if(Pred&& pred)
+		{
+			uint64_t to = 0;
+			for (uint64_t from = 0; from < mSize; from++)
+			{
+				if (pred(mData[from])) continue;
+
+				if (to != from) mData[to] = std::move(mData[from]);
+				to++;
+			}
+
+			uint64_t removed = mSize - to;
+			for (uint64_t i = to; i < mSize; i++)
+				mData[i].~T();
+			mSize = to;
+
+			return removed;
+		}
+
+		void clear()
+		{
+			for (uint64_t i = 0; i < mSize; i++)
+				mData[i].~T();
+
+			mSize = 0;
+		}
+
+		void resize(uint64_t newSize)
+		{
+			reserve(newSize);
+			for (uint64_t i = newSize; i < mSize; i++)
+				mData[i].~T();
+			for (uint64_t i = mSize; i < newSize; i++)
+				Memory::Emplace<T>(&mData[i]);
+
+			mSize = newSize;
+		}
+		void resize(uint64_t newSize, const T& value)
+		{
+			T copy(value); // value may live in the buffer being replaced
+			reserve(newSize);
+			for (uint64_t i = newSize; i < mSize; i++)
+				mData[i].~T();
+			for (uint64_t i = mSize; i < newSize; i++)
+				Memory::Emplace<T>(&mData[i], copy);
+
+			mSize = newSize;
+		}
+
+		void reserve(uint64_t newCapacity)
+		{
+			if (newCapacity <= mCapacity) return;
+
+			ReAlloc(newCapacity);
+		}
+
+	public: // Iterator Methods
+		Iterator begin() { return Iterator(mData); }
+		const Iterator begin() const { return Iterator(mData); }
+		Iterator end() { return Iterator(mData + mSize); }
+		const Iterator end() const { return Iterator(mData + mSize); }
+
+	public:
+		uint64_t size() const { return mSize; }
+		uint64_t capacity() const { return mCapacity; }
+		bool empty() const { return mSize == 0; }
+
+		using Storage::allocator;
+
+		// True while the elements are stored in the object itself
+		bool isInline() const { return mData == reinterpret_cast<const T*>(mInline); }
+
+	private:
+		T* Inline() { return reinterpret_cast<T*>(mInline); }
+
+		// Only ever grows, the inline buffer is never returned to
+		void ReAlloc(uint64_t newCapacity)
+		{
+			T* newBlock = this->template Allocate<T>(newCapacity);
+			Relocate(newBlock, mData, mSize);
+
+			if (!isInline()) this->template Deallocate<T>(mData, mCapacity);
+			mData = newBlock;
+			mCapacity = newCapacity;
+		}
+
+		// Takes other's elements, stealing its heap buffer if it has one. Expects this to be empty and inline.
+		void MoveFrom(mSmallArray& other)
+		{
+			if (other.isInline())
+			{
+				Relocate(mData, other.mData, other.mSize);
+			}
+			else
+			{
+				mData = other.mData;
+				mCapacity = other.mCapacity;
+				other.mData = other.Inline();
+				other.mCapacity = N;
+			}
+
+			mSize = other.mSize;
+			other.mSize = 0;
+		}
+
+		// Moves count elements to uninitialised memory at dst, leaving nothing to destroy at src
+		static void Relocate(T* dst, T* src, uint64_t count)
+		{
+			if constexpr (Relocatable)
+			{
+				if (count > 0) memcpy((void*)dst, (const void*)src, count * sizeof(T));
+			}
+			else
+			{
+				for (uint64_t i = 0; i < count; i++)
+				{
+					Memory::Emplace<T>(&dst[i], std::move(src[i]));
+					src[i].~T();
+				}
+			}
+		}
+	};
+
+}
\ No newline at end of file
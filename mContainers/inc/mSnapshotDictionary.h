@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+namespace mContainers {
+
+    // Versioned wrapper for read-mostly dictionaries with a single writer thread. Readers pin the current
+    // version with a store to their own cache line and one atomic pointer load, taking no locks and no shared
+    // reference counts. The writer builds the next version off to the side (copy-and-patch) and publishes it
+    // with one atomic exchange. Retired versions are freed once every reader has passed the epoch they were
+    // retired in (epoch-based grace periods). Any dictionary type works with publish(). update() copies the
+    // current version, so it needs a copy constructor that builds an independent table.
+    template<typename Dict, uint32_t MaxReaders = 64>
+    class mSnapshotDictionary
+    {
+    private:
+        static constexpr uint64_t Idle = (uint64_t)-1;
+
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t> epoch;    // Epoch the reader entered in, Idle outside of a read
+            std::atomic<bool> claimed;
+
+            ReaderSlot() : epoch(Idle), claimed(false) {}
+        };
+
+        struct Retired
+        {
+            const Dict* dict;
+            uint64_t epoch;
+
+            Retired() : dict(nullptr), epoch(0) {}
+            Retired(const Dict* _dict, uint64_t _epoch)
+                : dict(_dict), epoch(_epoch) {}
+        };
+
+    public:
+        // RAII read section. The snapshot stays valid and unchanged until the guard is destroyed.
+        class Snapshot
+        {
+        private:
+            ReaderSlot* mSlot;
+            const Dict* mDict;
+
+        public:
+            Snapshot(ReaderSlot* slot, const Dict* dict)
+                : mSlot(slot), mDict(dict) {}
+            Snapshot(const Snapshot&) = delete;
+            ~Snapshot()
+            {
+                mSlot->epoch.store(Idle, std::memory_order_release);
+            }
+
+            const Dict& operator*() const { return *mDict; }
+            const Dict* operator->() const { return mDict; }
+        };
+
+        // Per-thread reader registration. Holds one of the MaxReaders slots until destroyed, construction
+        // waits for a slot to be released when all of them are taken.
+        class Reader
+        {
+        private:
+            mSnapshotDictionary& mOwner;
+            ReaderSlot* mSlot;
+
+        public:
+            Reader(mSnapshotDictionary& owner)
+                : mOwner(owner), mSlot(owner.ClaimSlot()) {}
+            Reader(const Reader&) = delete;
+            ~Reader()
+            {
+                mSlot->claimed.store(false, std::memory_order_release);
+            }
+
+            Snapshot read()
+            {
+                mAssert(mSlot->epoch.load(std::memory_order_relaxed) == Idle, "Reader already holds a snapshot!");
+
+                // The epoch must be visible before the pointer is loaded, so the writer either sees this
+                // reader as active or the reader sees the newest version. Both are sequentially consistent.
+                mSlot->epoch.store(mOwner.mEpoch.load(std::memory_order_acquire));
+                return Snapshot(mSlot, mOwner.mCurrent.load());
+            }
+        };
+
+    private:
+        std::atomic<const Dict*> mCurrent;
+        std::atomic<uint64_t> mEpoch;
+        ReaderSlot mSlots[MaxReaders];
+        mDynArray<Retired> mRetired;    // Writer only
+
+    public:
+        mSnapshotDictionary()
+            : mCurrent(new Dict()), mEpoch(0) {}
+
+        // Takes ownership of the initial version
+        mSnapshotDictionary(Dict* initial)
+            : mCurrent(initial), mEpoch(0) {}
+
+        mSnapshotDictionary(const mSnapshotDictionary&) = delete;
+
+        // All readers must have been destroyed
+        ~mSnapshotDictionary()
+        {
+            for (uint64_t i = 0; i < mRetired.size(); i++)
+                delete mRetired[i].dict;
+
+            delete mCurrent.load();
+        }
+
+    public: // Writer Methods
+        // The latest published version, only safe to use from the writer thread
+        const Dict& current() const { return *mCurrent.load(std::memory_order_relaxed); }
+
+        // Publishes a new version, taking ownership of it. The previous version is retired.
+        void publish(Dict* next)
+        {
+            const Dict* previous = mCurrent.exchange(next);
+            uint64_t epoch = mEpoch.fetch_add(1);
+            mRetired.emplace_back(previous, epoch);
+
+            reclaim();
+        }
+
+        // Copies the current version, applies patch(Dict&) to the copy and publishes it.
+        template<typename Fn>
+        void update(Fn&& patch)
+        {
+            static_assert(std::is_copy_constructible_v<Dict>, "update() needs a copyable dictionary, use publish()!");
+
+            Dict* next = new Dict(current());
+            patch(*next);
+            publish(next);
+        }
+
+        // Frees every retired version no reader can still hold. Returns how many remain retired.
+        uint64_t reclaim()
+        {
+            uint64_t oldest = Idle;
+            for (uint32_t i = 0; i < MaxReaders; i++)
+            {
+                uint64_t epoch = mSlots[i].epoch.load();
+                if (epoch < oldest) oldest = epoch;
+            }
+
+            // A reader that loaded a version entered no later than the epoch that version was retired in
+            uint64_t kept = 0;
+            for (uint64_t i = 0; i < mRetired.size(); i++)
+            {
+                if (mRetired[i].epoch < oldest)
+                    delete mRetired[i].dict;
+                else
+                    mRetired[kept++] = mRetired[i];
+            }
+
+            while (mRetired.size() > kept)
+                mRetired.pop_back();
+
+            return kept;
+        }
+
+        uint64_t retiredCount() const { return mRetired.size(); }
+
+    private:
+        // Never fails, a reader past MaxReaders spins until another one is destroyed
+        ReaderSlot* ClaimSlot()
+        {
+            while (true)
+            {
+                for (uint32_t i = 0; i < MaxReaders; i++)
+                {
+                    bool expected = false;
+                    if (!mSlots[i].claimed.load(std::memory_order_relaxed) &&
+                        mSlots[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        return &mSlots[i];
+                }
+
+                std::this_thread::yield();
+            }
+        }
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+#include "mCore.h"
+#include "mSpan.h"
+
+namespace mContainers {
+
+	// Iterates the rows of an mBasicSoAArray. Dereferencing gives a tuple of references to the row's fields, so
+	// `for (auto [position, velocity] : particles)` binds straight to the elements.
+	template<typename Array>
+	class mSoAIterator
+	{
+	private:
+		Array* mArray;
+		uint64_t mIndex;
+
+	public:
+		mSoAIterator(Array* array, uint64_t index)
+			: mArray(array), mIndex(index) {}
+
+		auto operator*() const { return (*mArray)[mIndex]; }
+
+		mSoAIterator& operator++()
+		{
+			mIndex++;
+			return *this;
+		}
+		mSoAIterator operator++(int)
+		{
+			mSoAIterator it = *this;
+			++(*this);
+			return it;
+		}
+
+		mSoAIterator& operator--()
+		{
+			mIndex--;
+			return *this;
+		}
+		mSoAIterator operator--(int)
+		{
+			mSoAIterator it = *this;
+			--(*this);
+			return it;
+		}
+
+		mSoAIterator& operator+= (int64_t offset)
+		{
+			mIndex += offset;
+			return *this;
+		}
+		mSoAIterator operator+ (int64_t offset) const
+		{
+			mSoAIterator it = *this;
+			it += offset;
+			return it;
+		}
+		mSoAIterator& operator-= (int64_t offset)
+		{
+			return *this += -offset;
+		}
+		mSoAIterator operator- (int64_t offset) const
+		{
+			mSoAIterator it = *this;
+			it += -offset;
+			return it;
+		}
+
+		uint64_t operator- (const mSoAIterator& rhs) const
+		{
+			return mIndex - rhs.mIndex;
+		}
+
+		uint64_t index() const { return mIndex; }
+
+		bool operator== (const mSoAIterator& other) const
+		{
+			return mIndex == other.mIndex;
+		}
+		bool operator!= (const mSoAIterator& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	// Structure of arrays: one contiguous column per field instead of one array of structs, so a pass over a
+	// single field only reads that field. All columns share one buffer and grow together, each starting on its
+	// own cache line. Rows are accessed as tuples of references, columns as spans.
+	// The allocator comes first so the columns can stay a pack, mSoAArray<Ts...> uses the default one.
+	template<typename Allocator, typename... Ts>
+	class mBasicSoAArray : private mAllocatorStorage<Allocator>
+	{
+	public:
+		using VecType = mBasicSoAArray<Allocator, Ts...>;
+		using Iterator = mSoAIterator<VecType>;
+		using ConstIterator = mSoAIterator<const VecType>;
+		using Row = std::tuple<Ts&...>;
+		using ConstRow = std::tuple<const Ts&...>;
+
+		using AllocatorType = Allocator;
+
+		template<uint64_t I>
+		using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+		static constexpr uint64_t ColumnCount = sizeof...(Ts);
+		static constexpr uint64_t ColumnAlignment = 64;
+
+	private:
+		mStaticAssert(sizeof...(Ts) > 0, "An mSoAArray needs at least one column!")
+		mStaticAssert(((alignof(Ts) <= ColumnAlignment) && ...), "Column types can be at most cache line aligned!")
+
+		using Storage = mAllocatorStorage<Allocator>;
+		using Indices = std::index_sequence_for<Ts...>;
+
+		struct Buffer
+		{
+			unsigned char* memory;
+			uint64_t bytes;
+			std::tuple<Ts*...> columns;
+		};
+
+		Buffer mBuffer;
+		uint64_t mSize;
+		uint64_t mCapacity;
+
+	public:
+		// Nothing is allocated until the first row is added
+		mBasicSoAArray(const Allocator& allocator = Allocator())
+			: Storage(allocator), mBuffer(NewBuffer(0, Indices())), mSize(0), mCapacity(0) {}
+
+		explicit mBasicSoAArray(uint64_t count, const Allocator& allocator = Allocator())
+			: Storage(allocator), mBuffer(NewBuffer(0, Indices())), mSize(0), mCapacity(0)
+		{
+			resize(count);
+		}
+
+		mBasicSoAArray(const mBasicSoAArray& other)
+			: Storage(other.allocator()), mBuffer(NewBuffer(0, Indices())), mSize(0), mCapacity(0)
+		{
+			reserve(other.mSize);
+			ForEachColumn([&](auto column)
+			{
+				constexpr uint64_t I = decltype(column)::value;
+				for (uint64_t i = 0; i < other.mSize; i++)
+					Memory::Emplace<ColumnType<I>>(&std::get<I>(mBuffer.columns)[i], std::get<I>(other.mBuffer.columns)[i]);
+			});
+			mSize = other.mSize;
+		}
+
+		mBasicSoAArray(mBasicSoAArray&& other)
+			: Storage(other.allocator()), mBuffer(NewBuffer(0, Indices())), mSize(0), mCapacity(0)
+		{
+			swap(other);
+		}
+
+		~mBasicSoAArray()
+		{
+			clear();
+			Release(mBuffer);
+		}
+
+		VecType& operator=(const mBasicSoAArray& other)
+		{
+			if (this == &other) return *this;
+
+			mBasicSoAArray copy(other);
+			swap(copy);
+			return *this;
+		}
+		VecType& operator=(mBasicSoAArray&& other)
+		{
+			swap(other);
+			return *this;
+		}
+
+		void swap(mBasicSoAArray& other)
+		{
+			std::swap(allocator(), other.allocator());
+			std::swap(mBuffer, other.mBuffer);
+			std::swap(mSize, other.mSize);
+			std::swap(mCapacity, other.mCapacity);
+		}
+
+		using Storage::allocator;
+
+	public: // Access Operators
+		Row operator[](uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return RowAt<Row>(mBuffer.columns, index, Indices());
+		}
+		ConstRow operator[](uint64_t index) const
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return RowAt<ConstRow>(mBuffer.columns, index, Indices());
+		}
+
+		template<uint64_t I>
+		ColumnType<I>& get(uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return std::get<I>(mBuffer.columns)[index];
+		}
+		template<uint64_t I>
+		const ColumnType<I>& get(uint64_t index) const
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return std::get<I>(mBuffer.columns)[index];
+		}
+
+		// The Ith field of every row as one contiguous, cache line aligned run, valid until the array grows
+		template<uint64_t I>
+		mSpan<ColumnType<I>> column() { return mSpan<ColumnType<I>>(std::get<I>(mBuffer.columns), mSize); }
+		template<uint64_t I>
+		mSpan<const ColumnType<I>> column() const { return mSpan<const ColumnType<I>>(std::get<I>(mBuffer.columns), mSize); }
+
+	public: // Element Modifiers
+		void push_back(const Ts&... values) { emplace_back(values...); }
+
+		// One argument per column, each field is constructed from its own
+		template<typename... Args>
+		void emplace_back(Args&&... args)
+		{
+			mStaticAssert(sizeof...(Args) == sizeof...(Ts), "One value per column!")
+
+			if (mSize < mCapacity)
+			{
+				ConstructRow(mBuffer.columns, mSize, Indices(), std::forward<Args>(args)...);
+				mSize++;
+				return;
+			}
+
+			// The arguments may refer to fields of this array, so the new row is built before the rest move
+			const uint64_t newCapacity = mCapacity ? mCapacity * 2 : 4;
+			Buffer grown = NewBuffer(newCapacity, Indices());
+			ConstructRow(grown.columns, mSize, Indices(), std::forward<Args>(args)...);
+			MoveTo(grown, newCapacity);
+			mSize++;
+		}
+
+		void pop_back()
+		{
+			mAssert(mSize > 0, "Pop from an empty array!");
+
+			Destroy(mSize - 1, mSize);
+			mSize--;
+		}
+
+		// O(1) removal that moves the last row into the hole
+		void swap_remove(uint64_t index)
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			if (index != mSize - 1)
+			{
+				ForEachColumn([&](auto column)
+				{
+					auto* data = std::get<decltype(column)::value>(mBuffer.columns);
+					data[index] = std::move(data[mSize - 1]);
+				});
+			}
+			pop_back();
+		}
+
+		// Destroys the rows, the buffer is kept for reuse
+		void clear()
+		{
+			Destroy(0, mSize);
+			mSize = 0;
+		}
+
+		// New rows are default constructed
+		void resize(uint64_t newSize)
+		{
+			reserve(newSize);
+			Destroy(newSize < mSize ? newSize : mSize, mSize);
+			ForEachColumn([&](auto column)
+			{
+				constexpr uint64_t I = decltype(column)::value;
+				for (uint64_t i = mSize; i < newSize; i++)
+					Memory::Emplace<ColumnType<I>>(&std::get<I>(mBuffer.columns)[i]);
+			});
+
+			mSize = newSize;
+		}
+
+		// Grows every column at once, with a single allocation
+		void reserve(uint64_t newCapacity)
+		{
+			if (newCapacity <= mCapacity) return;
+
+			MoveTo(NewBuffer(newCapacity, Indices()), newCapacity);
+		}
+
+	public: // Iterator Methods
+		Iterator begin() { return Iterator(this, 0); }
+		ConstIterator begin() const { return ConstIterator(this, 0); }
+		Iterator end() { return Iterator(this, mSize); }
+		ConstIterator end() const { return ConstIterator(this, mSize); }
+
+	public:
+		uint64_t size() const { return mSize; }
+		uint64_t capacity() const { return mCapacity; }
+		bool empty() const { return mSize == 0; }
+
+	private:
+		static uint64_t ColumnBytes(uint64_t bytes)
+		{
+			return (bytes + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+		}
+
+		// Lays the columns out one after another in a single buffer, over allocated so the first can be aligned
+		template<size_t... Is>
+		Buffer NewBuffer(uint64_t capacity, std::index_sequence<Is...>)
+		{
+			if (capacity == 0) return Buffer{ nullptr, 0, std::tuple<Ts*...>(static_cast<Ts*>(nullptr)...) };
+
+			const uint64_t sizes[] = { ColumnBytes(capacity * sizeof(Ts))... };
+			uint64_t offsets[ColumnCount];
+			uint64_t total = 0;
+			for (uint64_t i = 0; i < ColumnCount; i++)
+			{
+				offsets[i] = total;
+				total += sizes[i];
+			}
+
+			Buffer buffer;
+			buffer.bytes = total + ColumnAlignment;
+			buffer.memory = this->template Allocate<unsigned char>(buffer.bytes);
+
+			uintptr_t base = ((uintptr_t)buffer.memory + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+			buffer.columns = std::tuple<Ts*...>(reinterpret_cast<Ts*>(base + offsets[Is])...);
+			return buffer;
+		}
+
+		void Release(Buffer& buffer)
+		{
+			if (buffer.memory) this->template Deallocate<unsigned char>(buffer.memory, buffer.bytes);
+		}
+
+		template<typename RowType, size_t... Is>
+		static RowType RowAt(const std::tuple<Ts*...>& columns, uint64_t index, std::index_sequence<Is...>)
+		{
+			return RowType(std::get<Is>(columns)[index]...);
+		}
+
+		template<size_t... Is, typename... Args>
+		static void ConstructRow(const std::tuple<Ts*...>& columns, uint64_t index, std::index_sequence<Is...>, Args&&... args)
+		{
+			(Memory::Emplace<Ts>(std::get<Is>(columns) + index, std::forward<Args>(args)), ...);
+		}
+
+		// Calls fn(std::integral_constant<size_t, I>()) for every column I
+		template<typename Fn>
+		static void ForEachColumn(Fn&& fn)
+		{
+			ForEachColumn(fn, Indices());
+		}
+		template<typename Fn, size_t... Is>
+		static void ForEachColumn(Fn& fn, std::index_sequence<Is...>)
+		{
+			(fn(std::integral_constant<size_t, Is>()), ...);
+		}
+
+		void Destroy(uint64_t first, uint64_t last)
+		{
+			ForEachColumn([&](auto column)
+			{
+				constexpr uint64_t I = decltype(column)::value;
+				using T = ColumnType<I>;
+				if constexpr (!std::is_trivially_destructible_v<T>)
+				{
+					for (uint64_t i = first; i < last; i++)
+						std::get<I>(mBuffer.columns)[i].~T();
+				}
+			});
+		}
+
+		// Moves the rows into grown and frees the old buffer
+		void MoveTo(const Buffer& grown, uint64_t newCapacity)
+		{
+			ForEachColumn([&](auto column)
+			{
+				constexpr uint64_t I = decltype(column)::value;
+				using T = ColumnType<I>;
+				T* src = std::get<I>(mBuffer.columns);
+				T* dst = std::get<I>(grown.columns);
+
+				if constexpr (mIsTriviallyRelocatable<T>::value)
+				{
+					if (mSize > 0) memcpy((void*)dst, (const void*)src, mSize * sizeof(T));
+				}
+				else
+				{
+					for (uint64_t i = 0; i < mSize; i++)
+					{
+						Memory::Emplace<T>(&dst[i], std::move(src[i]));
+						src[i].~T();
+					}
+				}
+			});
+
+			Release(mBuffer);
+			mBuffer = grown;
+			mCapacity = newCapacity;
+		}
+	};
+
+	template<typename... Ts>
+	using mSoAArray = mBasicSoAArray<Memory, Ts...>;
+
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mCore.h"
+
+namespace mContainers {
+
+	// A non-owning view over a contiguous run of elements. Like mBlock, the memory belongs to whatever
+	// handed out the span and the span is invalidated if that container reallocates.
+	template<typename T>
+	class mSpan
+	{
+	public:
+		using ValType = T;
+
+	private:
+		T* mData;
+		uint64_t mSize;
+
+	public:
+		mSpan() : mData(nullptr), mSize(0) {}
+		mSpan(T* data, uint64_t size)
+			: mData(data), mSize(size) {}
+
+		// Any container exposing data() and size(), e.g. mDynArray
+		template<typename Container>
+		mSpan(Container& container)
+			: mData(container.data()), mSize(container.size()) {}
+
+	public:
+		T& operator[](uint64_t index) const
+		{
+			mAssert(index < mSize, "Index out of range!");
+
+			return mData[index];
+		}
+
+		mSpan subspan(uint64_t offset, uint64_t count) const
+		{
+			mAssert(offset + count <= mSize, "Subspan out of range!");
+
+			return mSpan(mData + offset, count);
+		}
+
+		T* data() const { return mData; }
+		uint64_t size() const { return mSize; }
+		bool empty() const { return mSize == 0; }
+
+		T* begin() const { return mData; }
+		T* end() const { return mData + mSize; }
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <initializer_list>
+
+#include "mCore.h"
+#include "mDynArray.h"
+#include "mSpan.h"
+
+namespace mContainers {
+
+	// Component storage indexed by entity id. A paged sparse array maps an entity to its position in the packed
+	// entity and component arrays, so add, remove and lookup are O(1) and iterating the components is a linear
+	// walk. Pages are only allocated once an id in their range is used. Remove moves the last component into
+	// the hole, so the order of components changes. T must be default constructable.
+	// The allocator is shared by the pages and the packed arrays.
+	template<typename T, typename Entity = uint32_t, typename Allocator = Memory>
+	class mSparseSet : private mAllocatorStorage<Allocator>
+	{
+	private:
+		using Storage = mAllocatorStorage<Allocator>;
+
+		static constexpr uint64_t PageSize = 4096;
+		static constexpr uint32_t NoIndex = (uint32_t)-1;
+
+	public:
+		using ValType = T;
+		using EntityType = Entity;
+
+	private:
+		mDynArray<uint32_t*, Allocator> mPages;	// nullptr for pages without any entity
+		mDynArray<Entity, Allocator> mEntities;
+		mDynArray<T, Allocator> mComponents;
+
+	public:
+		mSparseSet(const Allocator& allocator = Allocator())
+			: Storage(allocator), mPages(allocator), mEntities(allocator), mComponents(allocator) {}
+		mSparseSet(const mSparseSet&) = delete;
+		mSparseSet& operator=(const mSparseSet&) = delete;
+
+		~mSparseSet()
+		{
+			for (uint64_t i = 0; i < mPages.size(); i++)
+				if (mPages[i]) this->template Deallocate<uint32_t>(mPages[i], PageSize);
+		}
+
+		using Storage::allocator;
+
+	public: // Access Operators
+		bool contains(Entity entity) const { return Index(entity) != NoIndex; }
+
+		T* get(Entity entity)
+		{
+			uint32_t index = Index(entity);
+			return index == NoIndex ? nullptr : &mComponents[index];
+		}
+		const T* get(Entity entity) const
+		{
+			uint32_t index = Index(entity);
+			return index == NoIndex ? nullptr : &mComponents[index];
+		}
+
+		T& operator[](Entity entity)
+		{
+			uint32_t index = Index(entity);
+			mAssert(index != NoIndex, "Entity has no component in this set!");
+
+			return mComponents[index];
+		}
+		const T& operator[](Entity entity) const
+		{
+			uint32_t index = Index(entity);
+			mAssert(index != NoIndex, "Entity has no component in this set!");
+
+			return mComponents[index];
+		}
+
+	public: // Iterator Methods
+		auto begin() { return mComponents.begin(); }
+		const auto begin() const { return mComponents.begin(); }
+		auto end() { return mComponents.end(); }
+		const auto end() const { return mComponents.end(); }
+
+		// Packed arrays, entities()[i] owns components()[i]
+		mSpan<const Entity> entities() const { return mSpan<const Entity>(mEntities.data(), mEntities.size()); }
+		mSpan<T> components() { return mSpan<T>(mComponents.data(), mComponents.size()); }
+		mSpan<const T> components() const { return mSpan<const T>(mComponents.data(), mComponents.size()); }
+
+		// Calls fn(entity, component) for every component, in packed order
+		template<typename Fn>
+		void forEach(Fn&& fn)
+		{
+			for (uint64_t i = 0; i < mComponents.size(); i++)
+				fn(mEntities[i], mComponents[i]);
+		}
+
+	public: // Element Modifiers
+		// Returns the existing component if the entity already has one
+		T& insert(Entity entity, const T& component)
+		{
+			uint32_t index = Index(entity);
+			if (index != NoIndex) return mComponents[index];
+
+			Slot(entity) = (uint32_t)mComponents.size();
+			mEntities.emplace_back(entity);
+			return mComponents.emplace_back(component);
+		}
+
+		template<typename... Args>
+		T& emplace(Entity entity, Args&&... args)
+		{
+			uint32_t index = Index(entity);
+			if (index != NoIndex) return mComponents[index];
+
+			Slot(entity) = (uint32_t)mComponents.size();
+			mEntities.emplace_back(entity);
+			return mComponents.emplace_back(std::forward<Args>(args)...);
+		}
+
+		bool remove(Entity entity)
+		{
+			uint32_t index = Index(entity);
+			if (index == NoIndex) return false;
+
+			uint32_t last = (uint32_t)mComponents.size() - 1;
+			if (index != last)
+			{
+				mComponents[index] = std::move(mComponents[last]);
+				mEntities[index] = mEntities[last];
+				Slot(mEntities[index]) = index;
+			}
+			mComponents.pop_back();
+			mEntities.pop_back();
+
+			Slot(entity) = NoIndex;
+			return true;
+		}
+
+		void clear()
+		{
+			for (uint64_t i = 0; i < mEntities.size(); i++)
+				Slot(mEntities[i]) = NoIndex;
+
+			mEntities.clear();
+			mComponents.clear();
+		}
+
+		void reserve(uint64_t count)
+		{
+			mEntities.reserve(count);
+			mComponents.reserve(count);
+		}
+
+	public:
+		uint64_t size() const { return mComponents.size(); }
+		bool empty() const { return mComponents.size() == 0; }
+
+	private:
+		uint32_t Index(Entity entity) const
+		{
+			uint64_t page = (uint64_t)entity / PageSize;
+			if (page >= mPages.size() || !mPages[page]) return NoIndex;
+
+			return mPages[page][(uint64_t)entity % PageSize];
+		}
+
+		// Sparse slot for the entity, allocating its page if needed
+		uint32_t& Slot(Entity entity)
+		{
+			uint64_t page = (uint64_t)entity / PageSize;
+			while (mPages.size() <= page)
+				mPages.emplace_back(nullptr);
+
+			if (!mPages[page])
+			{
+				mPages[page] = this->template Allocate<uint32_t>(PageSize);
+				memset(mPages[page], 0xFF, PageSize * sizeof(uint32_t));
+			}
+
+			return mPages[page][(uint64_t)entity % PageSize];
+		}
+	};
+
+	// Calls fn(entity, components...) for every entity present in all of the sets. Only the smallest set is
+	// walked, the others are probed through their sparse arrays. The sets must not be modified during the join.
+	template<typename Fn, typename First, typename... Rest>
+	void SparseJoin(Fn&& fn, First& first, Rest&... rest)
+	{
+		using Entity = typename First::EntityType;
+
+		mSpan<const Entity> smallest = first.entities();
+		for (mSpan<const Entity> entities : std::initializer_list<mSpan<const Entity>>{ rest.entities()... })
+			if (entities.size() < smallest.size()) smallest = entities;
+
+		for (uint64_t i = 0; i < smallest.size(); i++)
+		{
+			Entity entity = smallest[i];
+			if (first.contains(entity) && (rest.contains(entity) && ...))
+				fn(entity, first[entity], rest[entity]...);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "mCore.h"
+#include "mDynArray.h"
+
+namespace mContainers {
+
+	// Shared pool of worker threads for the parallel container operations. Work is submitted as a number of
+	// independent tasks which the workers (and the calling thread) claim one at a time until none are left.
+	// Calls made from inside a task, or while another thread is using the pool, run serially on the caller.
+	class mThreadPool
+	{
+	private:
+		struct Job
+		{
+			void (*invoke)(void*, uint64_t);
+			void* context;
+			uint64_t count;
+			std::atomic<uint64_t> next;
+			uint64_t active; // Workers still executing tasks, guarded by mMutex
+
+			Job(void (*_invoke)(void*, uint64_t), void* _context, uint64_t _count)
+				: invoke(_invoke), context(_context), count(_count), next(0), active(0) {}
+		};
+
+	private:
+		mDynArray<std::thread> mWorkers;
+		std::mutex mMutex;
+		std::mutex mRunMutex;
+		std::condition_variable mWake;
+		std::condition_variable mDone;
+		Job* mJob;
+		uint64_t mGeneration;
+		bool mStop;
+
+		static inline thread_local bool sInsidePool = false;
+		static inline std::atomic<mThreadPool*> sShared = nullptr;
+
+	public:
+		mThreadPool(uint32_t threadCount = std::thread::hardware_concurrency())
+			: mJob(nullptr), mGeneration(0), mStop(false)
+		{
+			// The calling thread always takes part, so one fewer worker is needed
+			for (uint32_t i = 1; i < threadCount; i++)
+				mWorkers.emplace_back([this]() { WorkerLoop(); });
+		}
+
+		mThreadPool(const mThreadPool&) = delete;
+
+		~mThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mStop = true;
+			}
+			mWake.notify_all();
+
+			for (std::thread& worker : mWorkers)
+				worker.join();
+		}
+
+		static mThreadPool& Get()
+		{
+			static mThreadPool sPool;
+			mThreadPool* shared = sShared.load(std::memory_order_acquire);
+			return shared ? *shared : sPool;
+		}
+
+		// Makes Get() return another pool while in scope, e.g. to run the parallel paths with a fixed number of
+		// threads whatever the machine has. Scopes nest and must not overlap with running container operations.
+		class Scope
+		{
+		private:
+			mThreadPool* mPrevious;
+
+		public:
+			Scope(mThreadPool& pool)
+				: mPrevious(sShared.exchange(&pool)) {}
+			Scope(const Scope&) = delete;
+			~Scope()
+			{
+				sShared.store(mPrevious);
+			}
+		};
+
+		// Number of threads that execute tasks, including the caller
+		uint32_t size() const { return (uint32_t)mWorkers.size() + 1; }
+
+		// Runs fn(taskIndex) for every task in [0, taskCount) and returns once all have finished.
+		template<typename Fn>
+		void run(uint64_t taskCount, Fn&& fn)
+		{
+			if (taskCount == 0) return;
+
+			if (taskCount == 1 || mWorkers.size() == 0 || sInsidePool || !mRunMutex.try_lock())
+			{
+				for (uint64_t i = 0; i < taskCount; i++)
+					fn(i);
+				return;
+			}
+
+			using FnType = std::remove_reference_t<Fn>;
+			Job job([](void* context, uint64_t index) { (*static_cast<FnType*>(context))(index); }, (void*)&fn, taskCount);
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mJob = &job;
+				mGeneration++;
+			}
+			mWake.notify_all();
+
+			sInsidePool = true;
+			Execute(job);
+			sInsidePool = false;
+
+			// Every task has been claimed, wait for workers still running theirs before the job goes out of scope
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mJob = nullptr;
+				mDone.wait(lock, [&]() { return job.active == 0; });
+			}
+			mRunMutex.unlock();
+		}
+
+	private:
+		static void Execute(Job& job)
+		{
+			uint64_t index;
+			while ((index = job.next.fetch_add(1, std::memory_order_relaxed)) < job.count)
+				job.invoke(job.context, index);
+		}
+
+		void WorkerLoop()
+		{
+			sInsidePool = true;
+			uint64_t seen = 0;
+
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (true)
+			{
+				mWake.wait(lock, [&]() { return mStop || (mJob && mGeneration != seen); });
+				if (mStop) return;
+
+				seen = mGeneration;
+				Job* job = mJob;
+				job->active++;
+
+				lock.unlock();
+				Execute(*job);
+				lock.lock();
+
+				if (--job->active == 0) mDone.notify_all();
+			}
+		}
+	};
+
+	namespace Parallel {
+
+		// Stable counting sort of the indices [0, count) by partition, using per-task histograms and prefix
+		// offsets so each task scatters into its own disjoint slots without locks. partitionOf(i) must return
+		// a value in [0, partitions) and is called twice per index. On return order holds the indices grouped
+		// by partition and starts[p] is where partition p begins (starts has partitions + 1 entries).
+		template<typename PartitionFn>
+		void PartitionIndices(uint64_t count, uint64_t partitions, PartitionFn&& partitionOf,
+			mDynArray<uint64_t>& order, mDynArray<uint64_t>& starts)
+		{
+			mThreadPool& pool = mThreadPool::Get();
+			const uint64_t tasks = pool.size();
+
+			mDynArray<uint64_t> offsets(tasks * partitions, 0); // [task][partition]
+			pool.run(tasks, [&](uint64_t task)
+			{
+				uint64_t* histogram = &offsets[task * partitions];
+				for (uint64_t i = count * task / tasks; i < count * (task + 1) / tasks; i++)
+					histogram[partitionOf(i)]++;
+			});
+
+			// Partition major prefix sum, so within a partition earlier tasks (lower indices) come first
+			starts.clear();
+			starts.resize(partitions + 1, 0);
+			uint64_t sum = 0;
+			for (uint64_t p = 0; p < partitions; p++)
+			{
+				starts[p] = sum;
+				for (uint64_t task = 0; task < tasks; task++)
+				{
+					uint64_t partitionCount = offsets[task * partitions + p];
+					offsets[task * partitions + p] = sum;
+					sum += partitionCount;
+				}
+			}
+			starts[partitions] = sum;
+
+			order.clear();
+			order.resize(count);
+			pool.run(tasks, [&](uint64_t task)
+			{
+				uint64_t* offset = &offsets[task * partitions];
+				for (uint64_t i = count * task / tasks; i < count * (task + 1) / tasks; i++)
+					order[offset[partitionOf(i)]++] = i;
+			});
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -6,6 +6,10 @@
 #define get16bits(d) (*((const uint16_t *) (d)))
 #endif
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #if !defined (get16bits)
 #define get16bits(d) ((((uint32_t)(((const uint8_t *)(d))[1])) << 8)\
                        +(uint32_t)(((const uint8_t *)(d))[0]) )
@@ -55,6 +59,28 @@ namespace mContainers {
             return prime;
         }
 
+        // Number of trailing zero bits, value must be non-zero
+        inline uint32_t CountTrailingZeros(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return (uint32_t)index;
+#else
+            return (uint32_t)__builtin_ctzll(value);
+#endif
+        }
+
+        // Number of set bits
+        inline uint32_t PopCount(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            return (uint32_t)__popcnt64(value);
+#else
+            return (uint32_t)__builtin_popcountll(value);
+#endif
+        }
+
         template<typename Key>
         std::string KeyToString(const Key& key)
         {